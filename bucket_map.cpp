@@ -43,7 +43,7 @@ vector<T> BucketMap<T>::getElements(Rectangle area) const {
   vector<T> ret;
   Rectangle allBuckets = Rectangle(
       area.getPX() / bucketSize, area.getPY() / bucketSize,
-      area.getKX() / bucketSize, area.getKY() / bucketSize)
+      (area.getKX() - 1) / bucketSize + 1, (area.getKY() - 1) / bucketSize + 1)
     .intersection(Rectangle(buckets.getBounds()));
   for (Vec2 v : allBuckets)
     for (T elem : buckets[v])
@@ -13,6 +13,7 @@
 #include "monster.h"
 #include "options.h"
 #include "trigger.h"
+#include "shortest_path.h"
 
 template <class Archive>
 void Collective::serialize(Archive& ar, const unsigned int version) {
@@ -34,15 +35,28 @@ void Collective::serialize(Archive& ar, const unsigned int version) {
     & SVAR(constructions)
     & SVAR(minionEquipment)
     & SVAR(prisonerInfo)
-    & SVAR(minionTaskStrings)
-    & SVAR(delayedPos)
-    & SVAR(knownTiles)
+    & SVAR(minionTaskStrings);
+  if (version == 0) {
+    // Delays are kept in the danger table, which is rebuilt after loading.
+    unordered_map<Vec2, double> delayedPos;
+    ar & BOOST_SERIALIZATION_NVP(delayedPos);
+  }
+  ar& SVAR(knownTiles)
     & SVAR(technologies)
     & SVAR(numFreeTech)
     & SVAR(borderTiles)
-    & SVAR(lastCombat)
-    & SVAR(kills)
-    & SVAR(points)
+    & SVAR(lastCombat);
+  if (version < 2) {
+    vector<const Creature*> oldKills;
+    ar & boost::serialization::make_nvp("kills", oldKills);
+    Serialization::afterLoad([=] {
+      for (const Creature* c : oldKills)
+        kills.push_back(c->getUniqueId());
+    });
+    SKIP_SERIAL(kills);
+  } else
+    ar & SVAR(kills);
+  ar& SVAR(points)
     & SVAR(currentTasks)
     & SVAR(configId)
     & SVAR(credit)
@@ -524,6 +538,10 @@ MoveInfo Collective::getWorkerMove(Creature* c) {
   if (PTask t = control->getNewTask(c))
     if (t->getMove(c))
       return taskMap.addTask(std::move(t), c)->getMove(c);
+  if (Task* assigned = getAssignedTask(c)) {
+    taskMap.takeTask(c, assigned);
+    return assigned->getMove(c);
+  }
   if (Task* closest = taskMap.getTaskForWorker(c)) {
     taskMap.takeTask(c, closest);
     return closest->getMove(c);
@@ -542,6 +560,78 @@ MoveInfo Collective::getWorkerMove(Creature* c) {
   }
 }
 
+Task* Collective::getAssignedTask(Creature* c) {
+  if (!workerAssignments.count(c->getUniqueId()))
+    return nullptr;
+  Task* task = taskMap.getTask(workerAssignments.at(c->getUniqueId()));
+  workerAssignments.erase(c->getUniqueId());
+  if (!task || taskMap.getOwner(task) || taskMap.isLocked(c, task, getTime()))
+    return nullptr;
+  if (!task->getMove(c)) {
+    taskMap.lock(c, task, getTime());
+    return nullptr;
+  }
+  return task;
+}
+
+const static int maxAssignmentRounds = 3;
+const static int maxAssignmentDist = 200;
+const static int assignmentMargin = 5;
+const static int minAssignmentBatch = 2;
+
+// Matches idle workers with free tasks using one multi-source search per round instead of a search for every
+// worker-task pair. Each task position gets the closest idle worker for which it is the nearest task. Workers left
+// without a match, or alone in their batch, fall back to TaskMap::getTaskForWorker.
+void Collective::assignWorkerTasks() {
+  workerAssignments.clear();
+  vector<Creature*> idle;
+  for (Creature* c : getCreatures(MinionTrait::WORKER))
+    if (c->getLevel() == getLevel() && !taskMap.getTask(c))
+      idle.push_back(c);
+  if (idle.size() < minAssignmentBatch)
+    return;
+  map<Vec2, vector<Task*>> freeTasks = taskMap.getFreeTasks(getTime(), true);
+  if (freeTasks.empty())
+    freeTasks = taskMap.getFreeTasks(getTime());
+  MovementType movement(getTribe(), {MovementTrait::WALK});
+  auto entryFun = [&](Vec2 pos) {
+    return getLevel()->getSquare(pos)->canEnterEmpty(movement) ? 1.0 : ShortestPath::infinity; };
+  for (int i : Range(maxAssignmentRounds)) {
+    if (idle.empty() || freeTasks.empty())
+      break;
+    vector<Vec2> positions = getKeys(freeTasks);
+    for (Creature* c : idle)
+      positions.push_back(c->getPosition());
+    Rectangle area = Rectangle::boundingBox(positions).minusMargin(-assignmentMargin)
+        .intersection(getLevel()->getBounds());
+    Dijkstra dijkstra(area, getKeys(freeTasks), maxAssignmentDist, entryFun);
+    map<Vec2, Creature*> closest;
+    for (Creature* c : idle) {
+      Vec2 pos = c->getPosition();
+      if (dijkstra.isReachable(pos)) {
+        Vec2 source = dijkstra.getSource(pos);
+        if (!closest.count(source) || dijkstra.getDist(closest.at(source)->getPosition()) > dijkstra.getDist(pos))
+          closest[source] = c;
+      }
+    }
+    if (closest.empty())
+      break;
+    for (auto& elem : closest) {
+      Creature* c = elem.second;
+      vector<Task*>& tasks = freeTasks.at(elem.first);
+      for (Task* task : tasks)
+        if (!taskMap.isLocked(c, task, getTime())) {
+          workerAssignments[c->getUniqueId()] = task->getUniqueId();
+          removeElement(tasks, task);
+          removeElement(idle, c);
+          break;
+        }
+      if (tasks.empty())
+        freeTasks.erase(elem.first);
+    }
+  }
+}
+
 int Collective::getTaskDuration(Creature* c, MinionTask task) const {
   switch (task) {
     case MinionTask::CONSUME:
@@ -785,15 +875,96 @@ vector<Vec2> Collective::getExtendedTiles(int maxRadius, int minRadius) const {
   return extendedQueue;
 }
 
-vector<Vec2> Collective::getEnemyPositions() const {
+const static int dangerRadius = 10;
+const static int dangerTime = 20;
+const static int dangerRefreshTime = 10;
+// getExtendedTiles(dangerRadius) numbers the collective's own squares 1 and leaves out its outermost ring,
+// so it only reaches this many steps away from the collective.
+const static int nearSquaresDist = dangerRadius - 2;
+
+// Same as checking if the position is among getExtendedTiles(dangerRadius), but searching from the position.
+bool Collective::isNearSquares(Vec2 pos) const {
+  if (containsSquare(pos))
+    return true;
+  auto canEnter = [this](Vec2 v) {
+    return v.inRectangle(getLevel()->getBounds()) && getLevel()->getSquare(v)->canEnterEmpty({MovementTrait::WALK});
+  };
+  if (!canEnter(pos))
+    return false;
+  map<Vec2, int> dist {{pos, 0}};
+  queue<Vec2> q;
+  q.push(pos);
+  while (!q.empty()) {
+    Vec2 v = q.front();
+    q.pop();
+    for (Vec2 w : v.neighbors8())
+      if (containsSquare(w))
+        return true;
+      else if (dist.at(v) + 1 < nearSquaresDist && !dist.count(w) && canEnter(w)) {
+        dist[w] = dist.at(v) + 1;
+        q.push(w);
+      }
+  }
+  return false;
+}
+
+const Rectangle& Collective::getSquaresBounds() const {
+  if (!squaresBounds)
+    squaresBounds = Rectangle::boundingBox(vector<Vec2>(allSquares.begin(), allSquares.end()));
+  return *squaresBounds;
+}
+
+// Enemies are found through the level's bucket map. The area around an enemy is marked as dangerous again only
+// when it moves, or when the previous mark is about to expire.
+vector<Vec2> Collective::updateDanger() {
   vector<Vec2> enemyPos;
-  for (Vec2 pos : getExtendedTiles(10))
-    if (const Creature* c = getLevel()->getSquare(pos)->getCreature())
-      if (c->getTribe() != getTribe())
-        enemyPos.push_back(pos);
+  if (allSquares.empty())
+    return enemyPos;
+  if (!dangerTable)
+    dangerTable.reset(new Table<double>(getLevel()->getBounds(), -1));
+  Rectangle area = getSquaresBounds().minusMargin(-dangerRadius).intersection(getLevel()->getBounds());
+  map<UniqueEntity<Creature>::Id, DangerSource> current;
+  for (const Creature* c : getLevel()->getAllCreatures(area))
+    if (c->getTribe() != getTribe()) {
+      DangerSource source;
+      auto previous = dangerSources.find(c->getUniqueId());
+      if (previous != dangerSources.end() && previous->second.pos == c->getPosition())
+        source = previous->second;
+      else
+        source = {c->getPosition(), -1000, isNearSquares(c->getPosition())};
+      if (source.near) {
+        enemyPos.push_back(source.pos);
+        if (source.time + dangerRefreshTime <= getTime()) {
+          markDanger(source.pos, getTime() + dangerTime + dangerRefreshTime);
+          source.time = getTime();
+        }
+      }
+      current[c->getUniqueId()] = source;
+    }
+  dangerSources = current;
   return enemyPos;
 }
 
+void Collective::markDanger(Vec2 enemyPos, double delayTime) {
+  Table<int> dist(Rectangle(enemyPos - Vec2(dangerRadius, dangerRadius), enemyPos + Vec2(dangerRadius + 1,
+        dangerRadius + 1)).intersection(getLevel()->getBounds()), -1);
+  queue<Vec2> q;
+  dist[enemyPos] = 0;
+  q.push(enemyPos);
+  while (!q.empty()) {
+    Vec2 pos = q.front();
+    q.pop();
+    (*dangerTable)[pos] = max((*dangerTable)[pos], delayTime);
+    if (dist[pos] >= dangerRadius)
+      continue;
+    for (Vec2 v : pos.neighbors8())
+      if (v.inRectangle(dist.getBounds()) && dist[v] == -1 && containsSquare(v)) {
+        dist[v] = dist[pos] + 1;
+        q.push(v);
+      }
+  }
+}
+
 static int countNeighbor(Vec2 pos, const set<Vec2>& squares) {
   int num = 0;
   for (Vec2 v : pos.neighbors8())
@@ -1038,6 +1209,12 @@ static vector<SquareType> roomsNeedingLight {
   SquareId::LABORATORY,
 };
 
+// Same as checking if the creature could equip a plain sword.
+static bool canWieldWeapon(const Creature* c) {
+  return c->isHumanoid() && c->numGood(BodyPart::ARM) > 0
+      && c->getEquipment().getItem(EquipmentSlot::WEAPON).size() < c->getEquipment().getMaxItems(EquipmentSlot::WEAPON);
+}
+
 void Collective::tick(double time) {
   control->tick(time);
   considerHealingLeader();
@@ -1061,21 +1238,17 @@ void Collective::tick(double time) {
     if (!getAllSquares(elem.second.squares).empty() && elem.second.warning)
       setWarning(*elem.second.warning, false);
   setWarning(Warning::NO_WEAPONS, false);
-  PItem genWeapon = ItemFactory::fromId(ItemId::SWORD);
-  vector<Item*> freeWeapons = getAllItems([&](const Item* it) {
-      return it->getClass() == ItemClass::WEAPON && !minionEquipment.getOwner(it); }, false);
   for (Creature* c : getCreatures({MinionTrait::FIGHTER}, {MinionTrait::NO_EQUIPMENT})) {
-    if (usesEquipment(c) && c->equip(genWeapon.get()) && filter(freeWeapons,
-          [&] (const Item* it) { return minionEquipment.needs(c, it); }).empty()) {
+    if (usesEquipment(c) && canWieldWeapon(c) && getFreeEquipment([&](const Item* it) {
+            return it->getClass() == ItemClass::WEAPON && minionEquipment.needs(c, it); },
+          MinionEquipment::ARMOR, 1).empty()) {
       setWarning(Warning::NO_WEAPONS, true);
       Debug() << "Can't get weapon for " << c->getName();
       break;
     }
   }
-  vector<Vec2> enemyPos = getEnemyPositions();
-  if (!enemyPos.empty())
-    delayDangerousTasks(enemyPos, getTime() + 20);
-  else
+  vector<Vec2> enemyPos = updateDanger();
+  if (enemyPos.empty())
     alarmInfo.finishTime() = -1000;
   bool allSurrender = true;
   for (Vec2 v : enemyPos)
@@ -1099,13 +1272,8 @@ void Collective::tick(double time) {
       }
   }
   updateConstructions();
-  for (const ItemFetchInfo& elem : getFetchInfo()) {
-    for (Vec2 pos : getAllSquares())
-      fetchItems(pos, elem);
-    for (SquareType type : elem.additionalPos)
-      for (Vec2 pos : getSquares(type))
-        fetchItems(pos, elem);
-  }
+  updateItemFetching();
+  assignWorkerTasks();
 }
 
 const vector<Creature*>& Collective::getCreatures(MinionTrait trait) const {
@@ -1185,30 +1353,34 @@ void Collective::decreaseMoraleForKill(const Creature* killer, const Creature* v
     c->addMorale(victim == getLeader() ? -2 : -0.015);
 }
 
+void Collective::removeCreature(Creature* c) {
+  prisonerInfo.erase(c);
+  freeFromGuardPost(c);
+  removeElement(creatures, c);
+  minionAttraction.erase(c);
+  if (Task* task = taskMap.getTask(c)) {
+    if (!task->canTransfer()) {
+      task->cancel();
+      returnResource(taskMap.removeTask(task));
+    } else
+      taskMap.freeTaskDelay(task, getTime() + 50);
+  }
+  for (MinionTrait t : ENUM_ALL(MinionTrait))
+    if (contains(byTrait[t], c))
+      removeElement(byTrait[t], c);
+  if (auto spawnType = c->getSpawnType())
+    removeElement(bySpawnType[*spawnType], c);
+  removeFromAllTeams(c);
+}
+
 void Collective::onKillEvent(const Creature* victim1, const Creature* killer) {
   if (contains(creatures, victim1)) {
     Creature* victim = const_cast<Creature*>(victim1);
     if (hasTrait(victim, MinionTrait::PRISONER) && killer && contains(getCreatures(), killer)
       && prisonerInfo.at(victim).state() == PrisonerState::EXECUTE)
       returnResource({ResourceId::PRISONER_HEAD, 1});
-    prisonerInfo.erase(victim);
-    freeFromGuardPost(victim);
     decreaseMoraleForKill(killer, victim);
-    removeElement(creatures, victim);
-    minionAttraction.erase(victim);
-    if (Task* task = taskMap.getTask(victim)) {
-      if (!task->canTransfer()) {
-        task->cancel();
-        returnResource(taskMap.removeTask(task));
-      } else
-        taskMap.freeTaskDelay(task, getTime() + 50);
-    }
-    for (MinionTrait t : ENUM_ALL(MinionTrait))
-      if (contains(byTrait[t], victim))
-        removeElement(byTrait[t], victim);
-    if (auto spawnType = victim->getSpawnType())
-      removeElement(bySpawnType[*spawnType], victim);
-    removeFromAllTeams(victim);
+    removeCreature(victim);
     control->onCreatureKilled(victim, killer);
     if (killer)
       control->addMessage(PlayerMessage(victim->getAName() + " is killed by " + killer->getAName(),
@@ -1219,7 +1391,7 @@ void Collective::onKillEvent(const Creature* victim1, const Creature* killer) {
   if (victim1->getTribe() != getTribe() && (!killer || contains(creatures, killer))) {
     addMana(getKillManaScore(victim1));
     addMoraleForKill(killer, victim1);
-    kills.push_back(victim1);
+    kills.push_back(victim1->getUniqueId());
     points += victim1->getDifficultyPoints();
 /*    if (Creature* leader = getLeader())
       leader->increaseExpLevel(double(victim1->getDifficultyPoints()) / 200);*/
@@ -1228,6 +1400,18 @@ void Collective::onKillEvent(const Creature* victim1, const Creature* killer) {
   }
 }
 
+void Collective::onCreatureDiscarded(Creature* c) {
+  // Creatures that flew away or disappeared didn't trigger a KillEvent, so they are still members.
+  if (contains(creatures, c))
+    removeCreature(c);
+  minionPayment.erase(c);
+  lastCombat.erase(c);
+  pregnancies.erase(std::remove(pregnancies.begin(), pregnancies.end(), c), pregnancies.end());
+  taskMap.freeFromTask(c);
+  taskMap.unlock(c);
+  minionEquipment.discard(c);
+}
+
 double Collective::getStanding(const Deity* d) const {
   if (deityStanding.count(d))
     return deityStanding.at(d);
@@ -1328,11 +1512,16 @@ const set<Vec2>& Collective::getAllSquares() const {
 
 void Collective::claimSquare(Vec2 pos) {
   allSquares.insert(pos);
+  squaresBounds = Nothing();
+  squaresToFetch.insert(pos);
+  indexItems(pos);
 }
 
 void Collective::changeSquareType(Vec2 pos, SquareType from, SquareType to) {
   mySquares[from].erase(pos);
   mySquares[to].insert(pos);
+  onSquareChanged(pos, from);
+  onSquareChanged(pos, to);
 }
 
 bool Collective::containsSquare(Vec2 pos) const {
@@ -1370,6 +1559,7 @@ double Collective::getEfficiency(Vec2 pos) const {
 const double sizeBase = 0.5;
 
 void Collective::updateEfficiency(Vec2 pos, SquareType type) {
+  ++overlayVersion;
   if (getSquares(type).count(pos)) {
     squareEfficiency[pos] = 0;
     for (Vec2 v : pos.neighbors8())
@@ -1442,10 +1632,12 @@ double Collective::getTime() const {
 
 void Collective::addGuardPost(Vec2 pos) {
   guardPosts[pos] = {};
+  ++overlayVersion;
 }
 
 void Collective::removeGuardPost(Vec2 pos) {
   guardPosts.erase(pos);
+  ++overlayVersion;
 }
 
 bool Collective::isGuardPost(Vec2 pos) const {
@@ -1555,8 +1747,8 @@ void Collective::autoEquipment(Creature* creature, bool replace) {
           //should happen only when an item leaves the fortress and then is braught back
       minionEquipment.discard(it);
   }
-  for (Item* it : getAllItems([&](const Item* it) {
-      return minionEquipment.needs(creature, it, false, replace) && !minionEquipment.getOwner(it); }, false)) {
+  for (Item* it : getFreeEquipment([&](const Item* it) {
+      return minionEquipment.needs(creature, it, false, replace); })) {
     if (!it->canEquip()
         || slots[it->getEquipmentSlot()].size() < creature->getEquipment().getMaxItems(it->getEquipmentSlot())
         || minionEquipment.getItemValue(getWorstItem(slots[it->getEquipmentSlot()]))
@@ -1576,6 +1768,66 @@ void Collective::autoEquipment(Creature* creature, bool replace) {
   }
 }
 
+void Collective::indexItems(Vec2 pos) {
+  for (const Item* it : getLevel()->getSquare(pos)->getItems()) {
+    minionEquipment.indexItem(it, pos);
+    if (auto type = it->getTrapType())
+      trapItemIndex[*type][it->getUniqueId()] = pos;
+  }
+}
+
+void Collective::initItemIndex() {
+  if (!itemsIndexed) {
+    for (Vec2 v : getAllSquares())
+      indexItems(v);
+    itemsIndexed = true;
+  }
+}
+
+// Returns the item if it's still lying on the square.
+Item* Collective::getIndexedItem(UniqueEntity<Item>::Id id, Vec2 pos) const {
+  if (containsSquare(pos))
+    for (Item* it : getLevel()->getSquare(pos)->getItems())
+      if (it->getUniqueId() == id)
+        return it;
+  return nullptr;
+}
+
+vector<pair<Item*, Vec2>> Collective::getIndexedTrapItems(TrapType type) {
+  initItemIndex();
+  vector<pair<Item*, Vec2>> ret;
+  map<UniqueEntity<Item>::Id, Vec2>& index = trapItemIndex[type];
+  for (auto it = index.begin(); it != index.end();) {
+    if (Item* item = getIndexedItem(it->first, it->second)) {
+      if (!isItemMarked(item))
+        ret.emplace_back(item, it->second);
+      ++it;
+    } else
+      it = index.erase(it);
+  }
+  return ret;
+}
+
+// Returns unowned items lying in the collective, most valuable first. Items that have left their indexed square
+// are dropped from the index on the way.
+vector<Item*> Collective::getFreeEquipment(ItemPredicate predicate, Optional<MinionEquipment::EquipmentType> type,
+    int maxNum) {
+  initItemIndex();
+  vector<Item*> ret;
+  minionEquipment.visitIndexedItems(type, [&] (MinionEquipment::IndexedItem elem) {
+    Item* found = getIndexedItem(elem.first, elem.second);
+    if (!found)
+      minionEquipment.unindexItem(elem.first);
+    else if (!minionEquipment.getOwner(found) && predicate(found)) {
+      ret.push_back(found);
+      if (ret.size() >= maxNum)
+        return false;
+    }
+    return true;
+  });
+  return ret;
+}
+
 vector<Item*> Collective::getAllItems(ItemPredicate predicate, bool includeMinions) const {
   vector<Item*> allItems;
   for (Vec2 v : getAllSquares())
@@ -1642,11 +1894,13 @@ const map<Vec2, Collective::TrapInfo>& Collective::getTraps() const {
 
 void Collective::removeTrap(Vec2 pos) {
   traps.erase(pos);
+  ++overlayVersion;
 }
 
 void Collective::removeConstruction(Vec2 pos) {
   returnResource(taskMap.removeTask(constructions.at(pos).task()));
   constructions.erase(pos);
+  ++overlayVersion;
 }
 
 void Collective::destroySquare(Vec2 pos) {
@@ -1671,6 +1925,8 @@ void Collective::addConstruction(Vec2 pos, SquareType type, CostInfo cost, bool
     onConstructed(pos, type);
   } else if (!noCredit || hasResource(cost)) {
     constructions[pos] = {cost, false, 0, type, -1};
+    ++overlayVersion;
+    constructionSchedule.add(pos, getTime());
     updateConstructions();
   }
 }
@@ -1691,6 +1947,10 @@ bool Collective::isMarkedToDig(Vec2 pos) const {
   return taskMap.getMarked(pos);
 }
 
+int Collective::getOverlayVersion() const {
+  return overlayVersion + taskMap.getMarkedVersion();
+}
+
 void Collective::setPriorityTasks(Vec2 pos) {
   taskMap.setPriorityTasks(pos);
 }
@@ -1709,6 +1969,8 @@ set<TrapType> Collective::getNeededTraps() const {
 
 void Collective::addTrap(Vec2 pos, TrapType type) {
   traps[pos] = {type, false, 0};
+  ++overlayVersion;
+  trapSchedule.add(pos, getTime());
   updateConstructions();
 }
 
@@ -1717,12 +1979,15 @@ void Collective::onAppliedItem(Vec2 pos, Item* item) {
   if (traps.count(pos)) {
     traps[pos].marked() = 0;
     traps[pos].armed() = true;
+    ++overlayVersion;
   }
 }
 
 void Collective::onAppliedItemCancel(Vec2 pos) {
-  if (traps.count(pos))
+  if (traps.count(pos)) {
     traps.at(pos).marked() = 0;
+    trapSchedule.add(pos, getTime());
+  }
 }
 
 void Collective::onTorchBuilt(Vec2 pos, Trigger* t) {
@@ -1730,15 +1995,19 @@ void Collective::onTorchBuilt(Vec2 pos, Trigger* t) {
   torches.at(pos).marked() = 0;
   torches.at(pos).task() = -1;
   torches.at(pos).trigger() = t;
+  ++overlayVersion;
 }
 
 void Collective::onConstructed(Vec2 pos, SquareType type) {
-  if (!contains({SquareId::TREE_TRUNK}, type.getId()))
+  if (!contains({SquareId::TREE_TRUNK}, type.getId())) {
     allSquares.insert(pos);
+    squaresBounds = Nothing();
+  }
   CHECK(!getSquares(type).count(pos));
   for (auto& elem : mySquares)
       elem.second.erase(pos);
   mySquares[type].insert(pos);
+  onSquareChanged(pos, type);
   if (efficiencySquares.count(type))
     updateEfficiency(pos, type);
   if (contains({SquareId::FLOOR, SquareId::BRIDGE, SquareId::BARRICADE}, type.getId()))
@@ -1749,6 +2018,7 @@ void Collective::onConstructed(Vec2 pos, SquareType type) {
     constructions.at(pos).built() = true;
     constructions.at(pos).marked() = 0;
     constructions.at(pos).task() = -1;
+    ++overlayVersion;
   }
   if (type == SquareId::FLOOR) {
     for (Vec2 v : pos.neighbors4())
@@ -1761,81 +2031,115 @@ void Collective::onConstructed(Vec2 pos, SquareType type) {
 }
 
 void Collective::updateSectors(Vec2 pos) {
-  if (getLevel()->getSquare(pos)->canEnterEmpty(MovementType(getTribe(), {MovementTrait::WALK})))
+  bool canWalk = getLevel()->getSquare(pos)->canEnterEmpty(MovementType(getTribe(), {MovementTrait::WALK}));
+  bool canFly = getLevel()->getSquare(pos)->canEnterEmpty(
+      MovementType(getTribe(), {MovementTrait::WALK, MovementTrait::FLY}));
+  unlockTasks(pos, canWalk, canFly);
+  if (canWalk)
     sectors->add(pos);
   else
     sectors->remove(pos);
-  if (getLevel()->getSquare(pos)->canEnterEmpty(MovementType(getTribe(), {MovementTrait::WALK, MovementTrait::FLY})))
+  if (canFly)
     flyingSectors->add(pos);
   else
     flyingSectors->remove(pos);
-  taskMap.clearAllLocked();
+}
+
+// A task that failed getMove is retried early if the square changed next to it, or if the sector that the worker
+// is in is about to be joined with a sector adjacent to the task. Other locks expire with time. Joined sectors
+// are relabeled, so it must be called before the square is added.
+void Collective::unlockTasks(Vec2 pos, bool canWalk, bool canFly) {
+  taskMap.clearLocked([&](const Creature* c, Vec2 taskPos) {
+      return c->isDead() || taskPos.dist8(pos) <= 1 || (c->getLevel() == getLevel()
+          && ((canWalk && sectors->isConnecting(pos, c->getPosition(), taskPos))
+              || (canFly && flyingSectors->isConnecting(pos, c->getPosition(), taskPos))));
+  });
 }
 
 // after this time applying trap or building door is rescheduled (imp death, etc).
 const static int timeToBuild = 50;
 
+// after this time a trap, construction or torch that couldn't be started is looked at again.
+const static int blockedRetryTime = 5;
+
+void Collective::initSchedule() {
+  if (scheduleInitialized)
+    return;
+  for (auto& elem : traps)
+    trapSchedule.add(elem.first, elem.second.marked());
+  for (auto& elem : constructions)
+    constructionSchedule.add(elem.first, elem.second.marked());
+  for (auto& elem : torches)
+    torchSchedule.add(elem.first, elem.second.marked());
+  scheduleInitialized = true;
+}
+
+static set<Vec2> popDue(TimerWheel<Vec2>& schedule, double time) {
+  vector<Vec2> due = schedule.popDue(time);
+  return set<Vec2>(due.begin(), due.end());
+}
+
+// Only entries that are due are looked at. An entry that is waiting for its task, or can't be started yet,
+// is put back into its schedule.
 void Collective::updateConstructions() {
+  initSchedule();
   map<TrapType, vector<pair<Item*, Vec2>>> trapItems;
-  for (TrapType type : ENUM_ALL(TrapType))
-    trapItems[type] = getTrapItems(type, getAllSquares());
-  for (auto elem : traps)
-    if (!isDelayed(elem.first)) {
-      vector<pair<Item*, Vec2>>& items = trapItems.at(elem.second.type());
-      if (!items.empty()) {
-        if (!elem.second.armed() && elem.second.marked() <= getTime()) {
-          Vec2 pos = items.back().second;
-          taskMap.addTask(Task::applyItem(this, pos, items.back().first, elem.first), pos);
-          markItem(items.back().first);
-          items.pop_back();
-          traps[elem.first].marked() = getTime() + timeToBuild;
-        }
+  for (Vec2 pos : popDue(trapSchedule, getTime()))
+    if (traps.count(pos) && !traps.at(pos).armed()) {
+      TrapInfo& info = traps.at(pos);
+      if (info.marked() > getTime()) {
+        trapSchedule.add(pos, info.marked());
+        continue;
       }
-    }
-  for (auto& elem : constructions)
-    if (!isDelayed(elem.first) && elem.second.marked() <= getTime() && !elem.second.built()) {
-      if (!hasResource(elem.second.cost()))
+      if (!trapItems.count(info.type()))
+        trapItems[info.type()] = getIndexedTrapItems(info.type());
+      vector<pair<Item*, Vec2>>& items = trapItems.at(info.type());
+      if (isDelayed(pos) || items.empty()) {
+        trapSchedule.add(pos, getTime() + blockedRetryTime);
         continue;
-      elem.second.task() = taskMap.addTaskCost(Task::construction(this, elem.first, elem.second.type()), elem.first,
-          elem.second.cost())->getUniqueId();
-      elem.second.marked() = getTime() + timeToBuild;
-      takeResource(elem.second.cost());
+      }
+      Vec2 itemPos = items.back().second;
+      taskMap.addTask(Task::applyItem(this, itemPos, items.back().first, pos), itemPos);
+      markItem(items.back().first);
+      items.pop_back();
+      info.marked() = getTime() + timeToBuild;
+      trapSchedule.add(pos, info.marked());
     }
-  for (auto& elem : torches)
-    if (!isDelayed(elem.first) && elem.second.marked() <= getTime() && !elem.second.built()) {
-      elem.second.task() = taskMap.addTask(
-          Task::buildTorch(this, elem.first, elem.second.attachmentDir()), elem.first)->getUniqueId();
-      elem.second.marked() = getTime() + timeToBuild;
+  for (Vec2 pos : popDue(constructionSchedule, getTime()))
+    if (constructions.count(pos) && !constructions.at(pos).built()) {
+      ConstructionInfo& info = constructions.at(pos);
+      if (info.marked() > getTime()) {
+        constructionSchedule.add(pos, info.marked());
+        continue;
+      }
+      if (isDelayed(pos) || !hasResource(info.cost())) {
+        constructionSchedule.add(pos, getTime() + blockedRetryTime);
+        continue;
+      }
+      info.task() = taskMap.addTaskCost(Task::construction(this, pos, info.type()), pos, info.cost())->getUniqueId();
+      info.marked() = getTime() + timeToBuild;
+      constructionSchedule.add(pos, info.marked());
+      takeResource(info.cost());
     }
-}
-
-void Collective::delayDangerousTasks(const vector<Vec2>& enemyPos, double delayTime) {
-  int infinity = 1000000;
-  int radius = 10;
-  Table<int> dist(Rectangle::boundingBox(enemyPos)
-      .minusMargin(-radius)
-      .intersection(getLevel()->getBounds()), infinity);
-  queue<Vec2> q;
-  for (Vec2 v : enemyPos) {
-    dist[v] = 0;
-    q.push(v);
-  }
-  while (!q.empty()) {
-    Vec2 pos = q.front();
-    q.pop();
-    delayedPos[pos] = delayTime;
-    if (dist[pos] >= radius)
-      continue;
-    for (Vec2 v : pos.neighbors8())
-      if (v.inRectangle(dist.getBounds()) && dist[v] == infinity && containsSquare(v)) {
-        dist[v] = dist[pos] + 1;
-        q.push(v);
+  for (Vec2 pos : popDue(torchSchedule, getTime()))
+    if (torches.count(pos) && !torches.at(pos).built()) {
+      TorchInfo& info = torches.at(pos);
+      if (info.marked() > getTime()) {
+        torchSchedule.add(pos, info.marked());
+        continue;
       }
-  }
+      if (isDelayed(pos)) {
+        torchSchedule.add(pos, getTime() + blockedRetryTime);
+        continue;
+      }
+      info.task() = taskMap.addTask(Task::buildTorch(this, pos, info.attachmentDir()), pos)->getUniqueId();
+      info.marked() = getTime() + timeToBuild;
+      torchSchedule.add(pos, info.marked());
+    }
 }
 
 bool Collective::isDelayed(Vec2 pos) {
-  return delayedPos.count(pos) && delayedPos.at(pos) > getTime();
+  return dangerTable && (*dangerTable)[pos] > getTime();
 }
 
 void Collective::fetchAllItems(Vec2 pos) {
@@ -1843,16 +2147,19 @@ void Collective::fetchAllItems(Vec2 pos) {
     fetchItems(pos, elem, true);
 }
 
-void Collective::fetchItems(Vec2 pos, const ItemFetchInfo& elem, bool ignoreDelayed) {
+// Returns false if the square should be visited again later.
+bool Collective::fetchItems(Vec2 pos, const ItemFetchInfo& elem, bool ignoreDelayed) {
   if ((isDelayed(pos) && !ignoreDelayed) 
       || (traps.count(pos) && traps.at(pos).type() == TrapType::BOULDER && traps.at(pos).armed() == true))
-    return;
+    return false;
   for (SquareType type : elem.destination)
     if (getSquares(type).count(pos))
-      return;
+      return true;
   vector<Item*> equipment = getLevel()->getSquare(pos)->getItems(elem.predicate);
   if (!equipment.empty()) {
-    vector<Vec2> destination = getAllSquares(elem.destination);
+    if (!fetchDestinations.count(&elem))
+      fetchDestinations[&elem] = getAllSquares(elem.destination);
+    const vector<Vec2>& destination = fetchDestinations.at(&elem);
     if (!destination.empty()) {
       setWarning(elem.warning, false);
       if (elem.oneAtATime)
@@ -1863,6 +2170,53 @@ void Collective::fetchItems(Vec2 pos, const ItemFetchInfo& elem, bool ignoreDela
     } else
       setWarning(elem.warning, true);
   }
+  return true;
+}
+
+const static int fullFetchInterval = 50;
+
+// Only squares where items landed or which changed are checked for items to haul. Everything is checked once in a
+// while, because the predicates depend on state that changes without an event, e.g. minion equipment.
+void Collective::updateItemFetching() {
+  set<Vec2> squares;
+  if (fetchAllSquares || getTime() >= lastFullFetch + fullFetchInterval) {
+    squares = getAllSquares();
+    for (const ItemFetchInfo& elem : getFetchInfo())
+      for (SquareType type : elem.additionalPos)
+        for (Vec2 pos : getSquares(type))
+          squares.insert(pos);
+    squaresToFetch.clear();
+    fetchAllSquares = false;
+    lastFullFetch = getTime();
+  } else
+    swap(squares, squaresToFetch);
+  for (Vec2 pos : squares)
+    for (const ItemFetchInfo& elem : getFetchInfo()) {
+      bool additional = false;
+      for (SquareType type : elem.additionalPos)
+        if (getSquares(type).count(pos))
+          additional = true;
+      if ((containsSquare(pos) || additional) && !fetchItems(pos, elem))
+        squaresToFetch.insert(pos);
+    }
+}
+
+void Collective::onSquareChanged(Vec2 pos, SquareType type) {
+  squaresToFetch.insert(pos);
+  if (containsSquare(pos))
+    indexItems(pos);
+  fetchDestinations.clear();
+  for (const ItemFetchInfo& elem : getFetchInfo())
+    if (contains(elem.destination, type))
+      fetchAllSquares = true;
+}
+
+void Collective::onItemsLandedEvent(const Level* l, Vec2 pos) {
+  if (l == getLevel()) {
+    squaresToFetch.insert(pos);
+    if (containsSquare(pos))
+      indexItems(pos);
+  }
 }
 
 void Collective::onSurrenderEvent(Creature* who, const Creature* to) {
@@ -1876,6 +2230,7 @@ void Collective::onSquareReplacedEvent(const Level* l, Vec2 pos) {
     for (auto& elem : mySquares)
       if (elem.second.count(pos)) {
         elem.second.erase(pos);
+        onSquareChanged(pos, elem.first);
         if (efficiencySquares.count(elem.first))
           updateEfficiency(pos, elem.first);
       }
@@ -1883,7 +2238,9 @@ void Collective::onSquareReplacedEvent(const Level* l, Vec2 pos) {
       ConstructionInfo& info = constructions.at(pos);
       info.marked() = getTime() + 10; // wait a little before considering rebuilding
       info.built() = false;
+      ++overlayVersion;
       info.task() = -1;
+      constructionSchedule.add(pos, info.marked());
     }
     if (getConfig().keepSectors) {
       sectors->add(pos);
@@ -1895,6 +2252,8 @@ void Collective::onSquareReplacedEvent(const Level* l, Vec2 pos) {
 void Collective::onTrapTriggerEvent(const Level* l, Vec2 pos) {
   if (traps.count(pos) && l == getLevel()) {
     traps.at(pos).armed() = false;
+    ++overlayVersion;
+    trapSchedule.add(pos, getTime());
     if (traps.at(pos).type() == TrapType::SURPRISE)
       handleSurprise(pos);
   }
@@ -1905,6 +2264,8 @@ void Collective::onTrapDisarmEvent(const Level* l, const Creature* who, Vec2 pos
     control->addMessage(PlayerMessage(who->getAName() + " disarms a " 
           + Item::getTrapName(traps.at(pos).type()) + " trap.", PlayerMessage::HIGH));
     traps.at(pos).armed() = false;
+    ++overlayVersion;
+    trapSchedule.add(pos, getTime());
   }
 }
 
@@ -1937,6 +2298,8 @@ void Collective::onPickedUp(Vec2 pos, EntitySet<Item> items) {
 void Collective::onCantPickItem(EntitySet<Item> items) {
   for (auto id : items)
     unmarkItem(id);
+  // the items might have been moved anywhere
+  fetchAllSquares = true;
 }
 
 void Collective::addKnownTile(Vec2 pos) {
@@ -1948,6 +2311,7 @@ void Collective::addKnownTile(Vec2 pos) {
       }
     borderTiles.erase(pos);
     knownTiles[pos] = true;
+    ++overlayVersion;
     for (Vec2 v : pos.neighbors4())
       if (getLevel()->inBounds(v) && !knownTiles[v])
         borderTiles.insert(v);
@@ -2113,7 +2477,7 @@ bool Collective::isInCombat(const Creature* c) const {
   return lastCombat.count(c) && lastCombat.at(c) > c->getTime() -5;
 }
 
-vector<const Creature*> Collective::getKills() const {
+vector<UniqueEntity<Creature>::Id> Collective::getKills() const {
   return kills;
 }
 
@@ -2301,10 +2665,13 @@ void Collective::removeTorch(Vec2 pos) {
   if (task > -1)
     taskMap.removeTask(torches.at(pos).task());
   torches.erase(pos);
+  ++overlayVersion;
 }
 
 void Collective::addTorch(Vec2 pos) {
   torches[pos] = {false, 0.0, -1, (*getAdjacentWall(getLevel(), pos) - pos).getCardinalDir(), nullptr};
+  ++overlayVersion;
+  torchSchedule.add(pos, getTime());
 }
 
 bool Collective::canPlaceTorch(Vec2 pos) const {
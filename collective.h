@@ -9,6 +9,7 @@
 #include "task_map.h"
 #include "minion_attraction.h"
 #include "sectors.h"
+#include "timer_wheel.h"
 #include "minion_task.h"
 #include "gender.h"
 #include "item.h"
@@ -61,6 +62,8 @@ class Collective : public Task::Callback {
   MoveInfo getMove(Creature*);
   void setControl(PCollectiveControl);
   void tick(double time);
+  /** Forgets a creature that is about to be destroyed. Called by the model after the DiscardCreatureEvent.*/
+  void onCreatureDiscarded(Creature*);
   const Tribe* getTribe() const;
   Tribe* getTribe();
   double getStanding(const Deity*) const;
@@ -177,7 +180,9 @@ class Collective : public Task::Callback {
   };
 
   const vector<ItemFetchInfo>& getFetchInfo() const;
-  void fetchItems(Vec2 pos, const ItemFetchInfo&, bool ignoreDelayed = false);
+  bool fetchItems(Vec2 pos, const ItemFetchInfo&, bool ignoreDelayed = false);
+  void updateItemFetching();
+  void onSquareChanged(Vec2 pos, SquareType);
 
   struct ConstructionInfo : public NamedTupleBase<CostInfo, bool, double, SquareType, UniqueEntity<Task>::Id> {
     NAMED_TUPLE_STUFF(ConstructionInfo);
@@ -235,6 +240,8 @@ class Collective : public Task::Callback {
   void cutTree(Vec2);
   double getDangerLevel(bool includeExecutions = true) const;
   bool isMarkedToDig(Vec2) const;
+  /** Changes whenever a planned construction, trap, torch, guard post, dig mark or efficiency value changes.*/
+  int getOverlayVersion() const;
   void setPriorityTasks(Vec2);
 
   bool hasTech(TechId id) const;
@@ -248,7 +255,7 @@ class Collective : public Task::Callback {
   bool isInCombat(const Creature*) const;
   void addKnownTile(Vec2 pos);
 
-  vector<const Creature*> getKills() const;
+  vector<UniqueEntity<Creature>::Id> getKills() const;
   int getPoints() const;
 
   MinionEquipment& getMinionEquipment();
@@ -305,6 +312,7 @@ class Collective : public Task::Callback {
   static void registerTypes(Archive& ar);
 
   private:
+  void removeCreature(Creature*);
   void updateEfficiency(Vec2, SquareType);
   int getPaymentAmount(const Creature*) const;
   void makePayouts();
@@ -332,6 +340,7 @@ class Collective : public Task::Callback {
   REGISTER_HANDLER(EquipEvent, const Creature*, const Item*);
   REGISTER_HANDLER(PickupEvent, const Creature* c, const vector<Item*>& items);
   REGISTER_HANDLER(TortureEvent, Creature* who, const Creature* torturer);
+  REGISTER_HANDLER(ItemsLandedEvent, const Level*, Vec2 pos);
 
   CollectiveConfigId SERIAL(configId);
   const CollectiveConfig& getConfig() const;
@@ -362,9 +371,19 @@ class Collective : public Task::Callback {
   EnumSet<Warning> warnings;
   MoveInfo getDropItems(Creature*);
   MoveInfo getWorkerMove(Creature*);
+  void assignWorkerTasks();
+  void unlockTasks(Vec2 pos, bool canWalk, bool canFly);
+  Task* getAssignedTask(Creature*);
+  map<UniqueEntity<Creature>::Id, UniqueEntity<Task>::Id> workerAssignments;
   MoveInfo getTeamMemberMove(Creature*);
   bool usesEquipment(const Creature* c) const;
   void autoEquipment(Creature* creature, bool replace);
+  void indexItems(Vec2 pos);
+  void initItemIndex();
+  Item* getIndexedItem(UniqueEntity<Item>::Id, Vec2 pos) const;
+  vector<pair<Item*, Vec2>> getIndexedTrapItems(TrapType);
+  vector<Item*> getFreeEquipment(ItemPredicate, Optional<MinionEquipment::EquipmentType> = Nothing(),
+      int maxNum = 1000000);
   Item* getWorstItem(vector<Item*> items) const;
   int getTaskDuration(Creature*, MinionTask) const;
   map<UniqueEntity<Creature>::Id, string> SERIAL(minionTaskStrings);
@@ -401,6 +420,11 @@ class Collective : public Task::Callback {
   ItemPredicate unMarkedItems(ItemClass) const;
   map<Vec2, TrapInfo> SERIAL(traps);
   map<Vec2, TorchInfo> SERIAL(torches);
+  TimerWheel<Vec2> trapSchedule;
+  TimerWheel<Vec2> constructionSchedule;
+  TimerWheel<Vec2> torchSchedule;
+  bool scheduleInitialized = false;
+  void initSchedule();
   enum class PrisonerState { SURRENDER, PRISON, EXECUTE, TORTURE, SACRIFICE };
   struct PrisonerInfo : public NamedTupleBase<PrisonerState, UniqueEntity<Task>::Id> {
     NAMED_TUPLE_STUFF(PrisonerInfo);
@@ -411,15 +435,24 @@ class Collective : public Task::Callback {
   void clearPrisonerTask(Creature* prisoner);
   map<Creature*, PrisonerInfo> SERIAL(prisonerInfo);
   void updateConstructions();
-  void delayDangerousTasks(const vector<Vec2>& enemyPos, double delayTime);
   bool isDelayed(Vec2 pos);
-  unordered_map<Vec2, double> SERIAL(delayedPos);
-  vector<Vec2> getEnemyPositions() const;
+  vector<Vec2> updateDanger();
+  void markDanger(Vec2 enemyPos, double delayTime);
+  bool isNearSquares(Vec2 pos) const;
+  const Rectangle& getSquaresBounds() const;
+  mutable Optional<Rectangle> squaresBounds;
+  unique_ptr<Table<double>> dangerTable;
+  struct DangerSource {
+    Vec2 pos;
+    double time;
+    bool near;
+  };
+  map<UniqueEntity<Creature>::Id, DangerSource> dangerSources;
   double manaRemainder = 0;
   double getKillManaScore(const Creature*) const;
   void addMana(double);
   unordered_map<const Creature*, double> SERIAL(lastCombat);
-  vector<const Creature*> SERIAL(kills);
+  vector<UniqueEntity<Creature>::Id> SERIAL(kills);
   int SERIAL2(points, 0);
   unordered_map<const Creature*, MinionPaymentInfo> SERIAL(minionPayment);
   int SERIAL(nextPayoutTime);
@@ -432,6 +465,13 @@ class Collective : public Task::Callback {
   Creature* getConsumptionTarget(Creature* consumer);
   deque<Creature*> SERIAL(pregnancies);
   mutable vector<ItemFetchInfo> itemFetchInfo;
+  set<Vec2> squaresToFetch;
+  bool fetchAllSquares = true;
+  double lastFullFetch = -1000000;
+  map<const ItemFetchInfo*, vector<Vec2>> fetchDestinations;
+  bool itemsIndexed = false;
+  int overlayVersion = 0;
+  map<TrapType, map<UniqueEntity<Item>::Id, Vec2>> trapItemIndex;
   struct TeamInfo : public NamedTupleBase<vector<Creature*>, bool> {
     NAMED_TUPLE_STUFF(TeamInfo);
     NAME_ELEM(0, creatures);
@@ -441,4 +481,11 @@ class Collective : public Task::Callback {
   set<const Location*> SERIAL(knownLocations);
 };
 
+// Version 1 no longer stores the delayed positions of dangerous tasks, version 2 keeps ids of the killed
+// creatures.
+BOOST_CLASS_VERSION(Collective, 2)
+
+// Version 1 of the task map stores the time of every lock.
+BOOST_CLASS_VERSION(TaskMap<Collective::CostInfo>, 1)
+
 #endif
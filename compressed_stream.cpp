@@ -0,0 +1,225 @@
+/* Copyright (C) 2013-2014 Michal Brzozowski (rusolis@poczta.fm)
+
+   This file is part of KeeperRL.
+
+   KeeperRL is free software; you can redistribute it and/or modify it under the terms of the
+   GNU General Public License as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   KeeperRL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+   even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with this program.
+   If not, see http://www.gnu.org/licenses/ . */
+
+#include "stdafx.h"
+#include "compressed_stream.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+const static int blockSize = 1 << 16;
+const static int queueSize = 16;
+
+static gzFile openAt(const string& path, int flags, int offset, const string& mode) {
+  int fd = open(path.c_str(), flags | O_BINARY, 0644);
+  if (fd < 0)
+    return nullptr;
+  gzFile ret = nullptr;
+  if (lseek(fd, offset, SEEK_SET) == offset)
+    ret = gzdopen(fd, mode.c_str());
+  if (!ret)
+    ::close(fd);
+  return ret;
+}
+
+class CompressedOutputStream::Buffer : public std::streambuf {
+  public:
+  Buffer(const string& path, int level, int offset) : blocks(queueSize) {
+    file = openAt(path, O_WRONLY | O_CREAT | O_TRUNC, offset, "wb" + convertToString(level));
+    if (!file)
+      return;
+    startBlock();
+    compressor = thread([this] {
+        while (1) {
+          vector<char> block = blocks.pop();
+          if (block.empty())
+            break;
+          checksum = crc32(checksum, (const Bytef*) block.data(), block.size());
+          if (gzwrite(file, block.data(), block.size()) != int(block.size()))
+            failed = true;
+        }
+        if (gzclose(file) != Z_OK)
+          failed = true;
+    });
+  }
+
+  bool isOpen() const {
+    return file;
+  }
+
+  bool isClosed() const {
+    return !compressor.joinable();
+  }
+
+  uint32_t close() {
+    sendBlock();
+    blocks.push(vector<char>());
+    compressor.join();
+    CHECK(!failed) << "Failed writing compressed file";
+    return checksum;
+  }
+
+  virtual int overflow(int c) override {
+    if (isClosed())
+      return EOF;
+    sendBlock();
+    startBlock();
+    if (c != EOF) {
+      *pptr() = c;
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+  virtual int sync() override {
+    if (!isClosed()) {
+      sendBlock();
+      startBlock();
+    }
+    return 0;
+  }
+
+  private:
+  void startBlock() {
+    current.resize(blockSize);
+    setp(current.data(), current.data() + current.size());
+  }
+
+  void sendBlock() {
+    int size = pptr() - pbase();
+    if (size > 0) {
+      current.resize(size);
+      blocks.push(std::move(current));
+      current = vector<char>();
+    }
+    setp(nullptr, nullptr);
+  }
+
+  gzFile file;
+  vector<char> current;
+  BoundedQueue<vector<char>> blocks;
+  thread compressor;
+  std::atomic<bool> failed {false};
+  uint32_t checksum = crc32(0, nullptr, 0);
+};
+
+CompressedOutputStream::CompressedOutputStream(const string& path, int level, int offset)
+    : std::ostream(nullptr), buffer(new Buffer(path, level, offset)) {
+  if (buffer->isOpen())
+    rdbuf(buffer.get());
+  else
+    setstate(std::ios::badbit);
+}
+
+uint32_t CompressedOutputStream::close() {
+  CHECK(buffer->isOpen() && !buffer->isClosed());
+  return buffer->close();
+}
+
+CompressedOutputStream::~CompressedOutputStream() {
+  if (buffer->isOpen() && !buffer->isClosed())
+    buffer->close();
+}
+
+class CompressedInputStream::Buffer : public std::streambuf {
+  public:
+  Buffer(const string& path, int offset) : blocks(queueSize) {
+    file = openAt(path, O_RDONLY, offset, "rb");
+    if (!file)
+      return;
+    setg(nullptr, nullptr, nullptr);
+    decompressor = thread([this] {
+        while (!stopped) {
+          vector<char> block(blockSize);
+          int size = gzread(file, block.data(), block.size());
+          if (size <= 0)
+            break;
+          block.resize(size);
+          checksum = crc32(checksum, (const Bytef*) block.data(), block.size());
+          blocks.push(std::move(block));
+        }
+        gzclose(file);
+        blocks.push(vector<char>());
+    });
+  }
+
+  bool isOpen() const {
+    return file;
+  }
+
+  bool isClosed() const {
+    return !decompressor.joinable();
+  }
+
+  uint32_t close() {
+    while (!finished)
+      finished = blocks.pop().empty();
+    decompressor.join();
+    setg(nullptr, nullptr, nullptr);
+    return checksum;
+  }
+
+  ~Buffer() {
+    if (isClosed())
+      return;
+    // The reader might have stopped early, so drain the queue until the decompressor finishes.
+    stopped = true;
+    close();
+  }
+
+  virtual int underflow() override {
+    if (gptr() < egptr())
+      return traits_type::to_int_type(*gptr());
+    if (finished)
+      return EOF;
+    current = blocks.pop();
+    if (current.empty()) {
+      finished = true;
+      return EOF;
+    }
+    setg(current.data(), current.data(), current.data() + current.size());
+    return traits_type::to_int_type(*gptr());
+  }
+
+  private:
+  gzFile file;
+  vector<char> current;
+  BoundedQueue<vector<char>> blocks;
+  thread decompressor;
+  std::atomic<bool> stopped {false};
+  bool finished = false;
+  uint32_t checksum = crc32(0, nullptr, 0);
+};
+
+CompressedInputStream::CompressedInputStream(const string& path, int offset)
+    : std::istream(nullptr), buffer(new Buffer(path, offset)) {
+  if (buffer->isOpen())
+    rdbuf(buffer.get());
+  else
+    setstate(std::ios::badbit);
+}
+
+uint32_t CompressedInputStream::close() {
+  CHECK(buffer->isOpen() && !buffer->isClosed());
+  return buffer->close();
+}
+
+CompressedInputStream::~CompressedInputStream() {
+}
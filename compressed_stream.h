@@ -0,0 +1,55 @@
+/* Copyright (C) 2013-2014 Michal Brzozowski (rusolis@poczta.fm)
+
+   This file is part of KeeperRL.
+
+   KeeperRL is free software; you can redistribute it and/or modify it under the terms of the
+   GNU General Public License as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   KeeperRL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+   even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with this program.
+   If not, see http://www.gnu.org/licenses/ . */
+
+#ifndef _COMPRESSED_STREAM_H
+#define _COMPRESSED_STREAM_H
+
+#include "util.h"
+
+/** Writes a gzip file. The data is passed in blocks through a bounded queue to a separate thread that
+ compresses and writes it, so the writer only waits when it gets far ahead of the compression.*/
+class CompressedOutputStream : public std::ostream {
+  public:
+  /** The level goes from 1 (fastest) to 9 (smallest). The compressed data starts at the given offset,
+   the bytes before it are left for a header.*/
+  CompressedOutputStream(const string& path, int level = defaultLevel, int offset = 0);
+  ~CompressedOutputStream();
+
+  /** Writes the rest of the data and closes the file. Returns the crc32 of all data written.*/
+  uint32_t close();
+
+  const static int defaultLevel = 4;
+
+  private:
+  class Buffer;
+  unique_ptr<Buffer> buffer;
+};
+
+/** Reads a gzip file, decompressing ahead on a separate thread. Files that aren't compressed are read as they
+ are, so older saves still load.*/
+class CompressedInputStream : public std::istream {
+  public:
+  CompressedInputStream(const string& path, int offset = 0);
+  ~CompressedInputStream();
+
+  /** Skips the rest of the data and closes the file. Returns the crc32 of the whole data.*/
+  uint32_t close();
+
+  private:
+  class Buffer;
+  unique_ptr<Buffer> buffer;
+};
+
+#endif
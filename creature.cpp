@@ -66,18 +66,34 @@ void Creature::serialize(Archive& ar, const unsigned int version) {
     & SVAR(collapsed)
     & SVAR(injuredBodyParts)
     & SVAR(lostBodyParts)
-    & SVAR(hidden)
-    & SVAR(lastAttacker)
-    & SVAR(swapPositionCooldown)
+    & SVAR(hidden);
+  if (version == 0) {
+    const Creature* oldAttacker = nullptr;
+    ar & boost::serialization::make_nvp("lastAttacker", oldAttacker);
+    if (oldAttacker)
+      Serialization::afterLoad([=] { lastAttacker = oldAttacker->getUniqueId(); });
+    SKIP_SERIAL(lastAttacker);
+  } else
+    ar & SVAR(lastAttacker);
+  ar& SVAR(swapPositionCooldown)
     & SVAR(lastingEffects)
     & SVAR(unknownAttacker)
     & SVAR(privateEnemies)
     & SVAR(holding)
     & SVAR(controller)
     & SVAR(controllerStack)
-    & SVAR(creatureVisions)
-    & SVAR(kills)
-    & SVAR(difficultyPoints)
+    & SVAR(creatureVisions);
+  if (version == 0) {
+    vector<const Creature*> oldKills;
+    ar & boost::serialization::make_nvp("kills", oldKills);
+    Serialization::afterLoad([=] {
+      for (const Creature* c : oldKills)
+        kills.push_back(c->getUniqueId());
+    });
+    SKIP_SERIAL(kills);
+  } else
+    ar & SVAR(kills);
+  ar& SVAR(difficultyPoints)
     & SVAR(points)
     & SVAR(sectors)
     & SVAR(numAttacksThisTurn)
@@ -198,11 +214,11 @@ bool Creature::isDead() const {
   return dead;
 }
 
-const Creature* Creature::getLastAttacker() const {
+Optional<UniqueEntity<Creature>::Id> Creature::getLastAttacker() const {
   return lastAttacker;
 }
 
-vector<const Creature*> Creature::getKills() const {
+vector<UniqueEntity<Creature>::Id> Creature::getKills() const {
   return kills;
 }
 
@@ -925,6 +941,15 @@ void Creature::onKillEvent(const Creature* victim, const Creature* killer) {
     points += victim->getDifficultyPoints();
 }
 
+void Creature::onDiscardCreatureEvent(const Creature* c) {
+  knownHiding.erase(c);
+  unknownAttacker = filter(unknownAttacker, [c](const Creature* attacker) { return attacker != c; });
+  removeElementMaybe(privateEnemies, c);
+  if (holding == c)
+    holding = nullptr;
+  forgetVisibleCreature(c);
+}
+
 double Creature::getInventoryWeight() const {
   double ret = 0;
   for (Item* item : getEquipment().getItems())
@@ -1008,6 +1033,13 @@ void Creature::setTime(double t) {
   time = t;
 }
 
+const Creature* Creature::findLastAttacker() const {
+  if (lastAttacker)
+    return level->getModel()->getCreature(*lastAttacker);
+  else
+    return nullptr;
+}
+
 void Creature::tick(double realTime) {
   getDifficultyPoints();
   for (Item* item : equipment.getItems()) {
@@ -1030,7 +1062,7 @@ void Creature::tick(double realTime) {
   updateViewObject();
   if (isNotLiving() && lostOrInjuredBodyParts() >= 4) {
     you(MsgType::FALL_APART, "");
-    die(lastAttacker);
+    die(findLastAttacker());
     return;
   }
   if (health < 0.5) {
@@ -1039,7 +1071,7 @@ void Creature::tick(double realTime) {
   }
   if (health <= 0) {
     you(MsgType::DIE_OF, isAffected(LastingEffect::POISON) ? "poisoning" : "bleeding");
-    die(lastAttacker);
+    die(findLastAttacker());
   }
 
 }
@@ -1304,7 +1336,7 @@ bool Creature::takeDamage(const Attack& attack) {
   Debug() << getTheName() << " attacked by " << other->getName() << " damage " << attack.getStrength() << " defense " << defense;
   if (passiveAttack && other && other->getPosition().dist8(position) == 1) {
     Effect::applyToCreature(other, *passiveAttack, EffectStrength::NORMAL);
-    other->lastAttacker = this;
+    other->lastAttacker = getUniqueId();
   }
   if (attack.getStrength() > defense) {
     if (attackType == AttackType::EAT) {
@@ -1315,7 +1347,10 @@ bool Creature::takeDamage(const Attack& attack) {
       } else
         attackType = AttackType::BITE;
     }
-    lastAttacker = attack.getAttacker();
+    if (const Creature* attacker = attack.getAttacker())
+      lastAttacker = attacker->getUniqueId();
+    else
+      lastAttacker = Nothing();
     double dam = (defense == 0) ? 1 : double(attack.getStrength() - defense) / defense;
     dam *= damageMultiplier;
     if (!isNotLiving())
@@ -1514,7 +1549,7 @@ void Creature::heal(double amount, bool replaceLimbs) {
     if (health == 1) {
       you(MsgType::BLEEDING_STOPS, "");
       health = 1;
-      lastAttacker = nullptr;
+      lastAttacker = Nothing();
     }
     updateViewObject();
   }
@@ -1587,11 +1622,14 @@ vector<PItem> Creature::getCorpse() {
 }
 
 void Creature::die(const Creature* attacker, bool dropInventory, bool dCorpse) {
-  lastAttacker = attacker;
+  if (attacker)
+    lastAttacker = attacker->getUniqueId();
+  else
+    lastAttacker = Nothing();
   Debug() << getTheName() << " dies. Killed by " << (attacker ? attacker->getName() : "");
   controller->onKilled(attacker);
   if (attacker)
-    attacker->kills.push_back(this);
+    attacker->kills.push_back(getUniqueId());
   if (dropInventory)
     for (PItem& item : equipment.removeAllItems()) {
       getSquare()->dropItem(std::move(item));
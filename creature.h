@@ -131,8 +131,8 @@ class Creature : private CreatureAttributes, public Renderable, public CreatureV
 
   bool isDead() const;
   bool isBlind() const;
-  const Creature* getLastAttacker() const;
-  vector<const Creature*> getKills() const;
+  Optional<UniqueEntity<Creature>::Id> getLastAttacker() const;
+  vector<UniqueEntity<Creature>::Id> getKills() const;
   bool isHumanoid() const;
   bool isAnimal() const;
   bool isStationary() const;
@@ -279,6 +279,7 @@ class Creature : private CreatureAttributes, public Renderable, public CreatureV
 
   private:
   REGISTER_HANDLER(KillEvent, const Creature* victim, const Creature* killer);
+  REGISTER_HANDLER(DiscardCreatureEvent, const Creature*);
 
   int getRawAttr(AttrType) const;
   bool affects(LastingEffect effect) const;
@@ -305,6 +306,8 @@ class Creature : private CreatureAttributes, public Renderable, public CreatureV
   void spendTime(double time);
   BodyPart armOrWing() const;
   pair<double, double> getStanding(const Creature* c) const;
+  // Returns nullptr if the last attacker was already destroyed.
+  const Creature* findLastAttacker() const;
 
   Level* SERIAL2(level, nullptr);
   Vec2 SERIAL(position);
@@ -324,7 +327,7 @@ class Creature : private CreatureAttributes, public Renderable, public CreatureV
   bool SERIAL2(hidden, false);
   bool inEquipChain = false;
   int numEquipActions = 0;
-  const Creature* SERIAL2(lastAttacker, nullptr);
+  Optional<UniqueEntity<Creature>::Id> SERIAL(lastAttacker);
   int SERIAL2(swapPositionCooldown, 0);
   vector<const Creature*> SERIAL(unknownAttacker);
   vector<const Creature*> SERIAL(privateEnemies);
@@ -332,7 +335,7 @@ class Creature : private CreatureAttributes, public Renderable, public CreatureV
   PController SERIAL(controller);
   vector<PController> SERIAL(controllerStack);
   vector<CreatureVision*> SERIAL(creatureVisions);
-  mutable vector<const Creature*> SERIAL(kills);
+  mutable vector<UniqueEntity<Creature>::Id> SERIAL(kills);
   mutable double SERIAL2(difficultyPoints, 0);
   int SERIAL2(points, 0);
   Sectors* SERIAL2(sectors, nullptr);
@@ -401,4 +404,7 @@ enum class MsgType {
     GROW,
 };
 
+// Version 1 refers to the last attacker and to killed creatures by id.
+BOOST_CLASS_VERSION(Creature, 1)
+
 #endif
@@ -318,6 +318,15 @@ class KrakenController : public Monster {
         c->die(nullptr);
   }
 
+  REGISTER_HANDLER(DiscardCreatureEvent, const Creature* c) {
+    if (removeElementMaybe(spawns, const_cast<Creature*>(c)))
+      ++numSpawns;
+    if (held == c)
+      held = nullptr;
+    if (father && father->creature == c)
+      father = nullptr;
+  }
+
   virtual void you(MsgType type, const string& param) override {
     string msg, msgNoSee;
     switch (type) {
@@ -591,6 +600,26 @@ class ShopkeeperController : public Monster {
     }
   }
 
+  virtual void onKilled(const Creature* attacker) override {
+    // Nobody will ask for the money anymore.
+    for (Vec2 v : shopArea->getBounds())
+      for (Item* item : creature->getLevel()->getSquare(v)->getItems())
+        if (myItems.contains(item))
+          item->setShopkeeper(nullptr);
+    for (auto& elem : debt)
+      for (Item* item : elem.first->getEquipment().getItems())
+        if (unpaidItems[elem.first].contains(item))
+          item->setShopkeeper(nullptr);
+  }
+
+  REGISTER_HANDLER(DiscardCreatureEvent, const Creature* c) {
+    prevCreatures.erase(c);
+    debt.erase(c);
+    thiefCount.erase(c);
+    thieves.erase(c);
+    unpaidItems.erase(c);
+  }
+
   virtual int getDebt(const Creature* debtor) const override {
     if (debt.count(debtor)) {
       return debt.at(debtor);
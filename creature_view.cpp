@@ -27,6 +27,10 @@ void CreatureView::serialize(Archive& ar, const unsigned int version) {
 
 SERIALIZABLE(CreatureView);
 
+int CreatureView::getOverlayVersion() const {
+  return 0;
+}
+
 bool CreatureView::staticPosition() const {
   return true;
 }
@@ -48,6 +52,11 @@ void CreatureView::updateVisibleCreatures() {
       visibleEnemies.push_back(c);
 }
 
+void CreatureView::forgetVisibleCreature(const Creature* c) {
+  removeElementMaybe(visibleEnemies, c);
+  removeElementMaybe(visibleFriends, c);
+}
+
 vector<const Creature*> CreatureView::getVisibleEnemies() const {
   return visibleEnemies;
 }
@@ -35,8 +35,12 @@ class CreatureView {
   virtual const Tribe* getTribe() const = 0;
   virtual bool isEnemy(const Creature*) const = 0;
   virtual int getMaxSightRange() const = 0;
+  /** Changes whenever something drawn by getViewIndex changes without touching the square itself.*/
+  virtual int getOverlayVersion() const;
 
   void updateVisibleCreatures();
+  /** Removes a creature that is about to be destroyed from the visible enemies and friends.*/
+  void forgetVisibleCreature(const Creature*);
   vector<const Creature*> getVisibleEnemies() const;
   vector<const Creature*> getVisibleFriends() const;
 
@@ -49,7 +49,12 @@ class EventListener {
   EVENT(PickupEvent, const Creature*, const vector<Item*>& items);
   EVENT(DropEvent, const Creature*, const vector<Item*>& items);
   EVENT(ItemsAppearedEvent, const Level*, Vec2 position, const vector<Item*>& items);
+  // triggered whenever items are put on a square, for whatever reason
+  EVENT(ItemsLandedEvent, const Level*, Vec2 position);
   EVENT(KillEvent, const Creature* victim, const Creature* killer);
+  // triggered right before a dead creature is destroyed, also for ones that flew away or disappeared
+  // without a KillEvent; every pointer to it must be dropped
+  EVENT(DiscardCreatureEvent, const Creature*);
   EVENT(AttackEvent, Creature* victim, Creature* attacker);
   EVENT(ThrowEvent, const Level*, const Creature* thrower, const Item* item, const vector<Vec2>& trajectory);
   EVENT(ExplosionEvent, const Level* level, Vec2 pos);
@@ -20,9 +20,13 @@
 
 template <class Archive> 
 void FieldOfView::serialize(Archive& ar, const unsigned int version) {
-  ar & SVAR(squares)
-     & SVAR(visibility)
-     & SVAR(vision);
+  ar & SVAR(squares);
+  // Visibility is computed on demand, so skipping it keeps saves of big dungeons small and fast to load.
+  if (version == 0)
+    ar & boost::serialization::make_nvp("visibility", visibility);
+  else if (Archive::is_loading::value)
+    visibility = Table<Optional<Visibility>>(squares->getWidth(), squares->getHeight());
+  ar & SVAR(vision);
   CHECK_SERIAL;
 }
 
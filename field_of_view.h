@@ -61,8 +61,12 @@ class FieldOfView {
   };
   
   const Table<PSquare>* SERIAL(squares);
-  Table<Optional<Visibility>> SERIAL(visibility);
+  /** Not saved since version 1, it's rebuilt lazily after loading.*/
+  Table<Optional<Visibility>> visibility;
   Vision* SERIAL(vision);
 };
 
+// Version 1 doesn't store the visibility cache.
+BOOST_CLASS_VERSION(FieldOfView, 1)
+
 #endif
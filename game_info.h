@@ -21,6 +21,11 @@ class GameInfo {
     double morale;
     double salary;
     double credit;
+
+    bool operator == (const CreatureInfo& o) const {
+      return std::tie(viewObject, uniqueId, name, speciesName, expLevel, morale, salary, credit)
+          == std::tie(o.viewObject, o.uniqueId, o.name, o.speciesName, o.expLevel, o.morale, o.salary, o.credit);
+    }
   };
 
   class BandInfo {
@@ -35,6 +40,11 @@ class GameInfo {
       string help;
       char hotkey;
       string groupName;
+
+      bool operator == (const Button& o) const {
+        return std::tie(object, name, cost, count, inactiveReason, help, hotkey, groupName)
+            == std::tie(o.object, o.name, o.cost, o.count, o.inactiveReason, o.help, o.hotkey, o.groupName);
+      }
     };
     vector<Button> buildings;
     vector<Button> workshop;
@@ -60,12 +70,20 @@ class GameInfo {
       ViewId viewId;
       string name;
       char hotkey;
+
+      bool operator == (const TechButton& o) const {
+        return std::tie(viewId, name, hotkey) == std::tie(o.viewId, o.name, o.hotkey);
+      }
     };
     vector<TechButton> techButtons;
 
     struct Deity {
       string name;
       double standing;
+
+      bool operator == (const Deity& o) const {
+        return std::tie(name, standing) == std::tie(o.name, o.standing);
+      }
     };
     vector<Deity> deities;
   } bandInfo;
@@ -77,11 +95,19 @@ class GameInfo {
       int value;
       int bonus;
       string help;
+
+      bool operator == (const AttributeInfo& o) const {
+        return std::tie(name, value, bonus, help) == std::tie(o.name, o.value, o.bonus, o.help);
+      }
     };
     vector<AttributeInfo> attributes;
     struct SkillInfo {
       string name;
       string help;
+
+      bool operator == (const SkillInfo& o) const {
+        return std::tie(name, help) == std::tie(o.name, o.help);
+      }
     };
     vector<SkillInfo> skills;
     bool possessed;
@@ -94,6 +120,10 @@ class GameInfo {
     struct Effect {
       string name;
       bool bad;
+
+      bool operator == (const Effect& o) const {
+        return std::tie(name, bad) == std::tie(o.name, o.bad);
+      }
     };
     vector<Effect> effects;
   } playerInfo;
@@ -104,6 +134,10 @@ class GameInfo {
       string name;
       string tribeName;
       string state;
+
+      bool operator == (const Village& o) const {
+        return std::tie(name, tribeName, state) == std::tie(o.name, o.tribeName, o.state);
+      }
     };
     vector<Village> villages;
   } villageInfo;
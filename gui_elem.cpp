@@ -442,6 +442,50 @@ class Invisible : public GuiLayout {
   }
 };
 
+class External : public GuiElem {
+  public:
+  External(GuiElem* e) : elem(e) {}
+
+  virtual void render(Renderer& r) override {
+    elem->render(r);
+  }
+
+  virtual void onLeftClick(Vec2 pos) override {
+    elem->onLeftClick(pos);
+  }
+
+  virtual void onRightClick(Vec2 pos) override {
+    elem->onRightClick(pos);
+  }
+
+  virtual void onMouseMove(Vec2 pos) override {
+    elem->onMouseMove(pos);
+  }
+
+  virtual void onMouseRelease() override {
+    elem->onMouseRelease();
+  }
+
+  virtual void onRefreshBounds() override {
+    elem->setBounds(getBounds());
+  }
+
+  virtual void onKeyPressed(char key) override {
+    elem->onKeyPressed(key);
+  }
+
+  virtual void onKeyPressed(Event::KeyEvent key) override {
+    elem->onKeyPressed(key);
+  }
+
+  private:
+  GuiElem* elem;
+};
+
+PGuiElem GuiElem::external(GuiElem* elem) {
+  return PGuiElem(new External(elem));
+}
+
 PGuiElem GuiElem::invisible(PGuiElem content) {
   return PGuiElem(new Invisible(std::move(content)));
 }
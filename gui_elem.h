@@ -84,6 +84,7 @@ class GuiElem {
   static PGuiElem border2(PGuiElem content);
   static PGuiElem mainDecoration(int rightBarWidth, int bottomBarHeight);
   static PGuiElem invisible(PGuiElem content);
+  static PGuiElem external(GuiElem*);
   static void changeBackground(int r, int g, int b);
   static void setBackground(int r, int g, int b);
   static Color background1;
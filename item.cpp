@@ -29,9 +29,19 @@ void Item::serialize(Archive& ar, const unsigned int version) {
   ar& SUBCLASS(UniqueEntity)
     & SUBCLASS(Renderable)
     & SVAR(discarded)
-    & SVAR(inspected)
-    & SVAR(shopkeeper)
-    & SVAR(fire);
+    & SVAR(inspected);
+  if (version == 0) {
+    const Creature* oldShopkeeper = nullptr;
+    ar & boost::serialization::make_nvp("shopkeeper", oldShopkeeper);
+    if (oldShopkeeper)
+      Serialization::afterLoad([=] {
+        if (!oldShopkeeper->isDead())
+          shopkeeper = oldShopkeeper->getUniqueId();
+      });
+    SKIP_SERIAL(shopkeeper);
+  } else
+    ar & SVAR(shopkeeper);
+  ar& SVAR(fire);
   CHECK_SERIAL;
 }
 
@@ -218,14 +228,14 @@ int Item::getPrice() const {
 }
 
 void Item::setShopkeeper(const Creature* s) {
-  shopkeeper = s;
+  if (s)
+    shopkeeper = s->getUniqueId();
+  else
+    shopkeeper = Nothing();
 }
 
-const Creature* Item::getShopkeeper() const {
-  if (!shopkeeper || shopkeeper->isDead())
-    return nullptr;
-  else
-    return shopkeeper;
+Optional<UniqueEntity<Creature>::Id> Item::getShopkeeper() const {
+  return shopkeeper;
 }
 
 Optional<TrapType> Item::getTrapType() const {
@@ -87,7 +87,8 @@ class Item : private ItemAttributes, public Renderable, public UniqueEntity<Item
   
   int getPrice() const;
   void setShopkeeper(const Creature* shopkeeper);
-  const Creature* getShopkeeper() const;
+  /** Returns the id of the shopkeeper that wasn't paid for the item yet. The shopkeeper may be gone already.*/
+  Optional<UniqueEntity<Creature>::Id> getShopkeeper() const;
 
   Optional<TrapType> getTrapType() const;
   Optional<CollectiveResourceId> getResourceId() const;
@@ -160,8 +161,11 @@ class Item : private ItemAttributes, public Renderable, public UniqueEntity<Item
   string getVisibleName(bool plural) const;
   string getRealName(bool plural) const;
   string getBlindName(bool plural) const;
-  const Creature* SERIAL2(shopkeeper, nullptr);
+  Optional<UniqueEntity<Creature>::Id> SERIAL(shopkeeper);
   Fire SERIAL(fire);
 };
 
+// Version 1 refers to the shopkeeper by id.
+BOOST_CLASS_VERSION(Item, 1)
+
 #endif
@@ -977,14 +977,18 @@ class RandomLocations : public LevelMaker {
   }
 
   virtual void make(Level::Builder* builder, Rectangle area) override {
-    vector<LocationPredicate::Precomputed> precomputed;
+    // Precomputing only reads the builder, so all predicates are done at once.
+    vector<unique_ptr<LocationPredicate::Precomputed>> precomputed(insideMakers.size());
+    vector<function<void()>> tasks;
     for (int i : All(insideMakers))
-      precomputed.push_back(predicate[i].precompute(builder, area));
+      tasks.push_back([&, i] {
+          precomputed[i].reset(new LocationPredicate::Precomputed(predicate[i].precompute(builder, area)));});
+    runInParallel(tasks);
     makeCnt(builder, precomputed, area, 3000);
   }
 
-  void makeCnt(Level::Builder* builder, vector<LocationPredicate::Precomputed>& precomputed, Rectangle area,
-      int tries) {
+  void makeCnt(Level::Builder* builder, vector<unique_ptr<LocationPredicate::Precomputed>>& precomputed,
+      Rectangle area, int tries) {
     vector<Rectangle> occupied;
     vector<Rectangle> makerBounds;
     vector<Level::Builder::Rot> maps;
@@ -1014,7 +1018,7 @@ class RandomLocations : public LevelMaker {
             ok = false;
             break;
           }
-        if (!precomputed[i].apply(Rectangle(px, py, px + width, py + height)))
+        if (!precomputed[i]->apply(Rectangle(px, py, px + width, py + height)))
           ok = false;
         else
           if (separate)
@@ -19,6 +19,7 @@
 #include "creature.h"
 #include "level.h"
 #include "square.h"
+#include "entity_set.h"
 
 template <class Archive> 
 void Location::serialize(Archive& ar, const unsigned int version) {
@@ -80,7 +81,7 @@ class TowerTopLocation : public Location {
   virtual void onCreature(Creature* c) override {
     if (!c->isPlayer())
       return;
-    if (!entered.count(c) && !c->isBlind()) {
+    if (!entered.contains(c) && !c->isBlind()) {
  /*     for (Vec2 v : c->getLevel()->getBounds())
         if ((v - c->getPosition()).lengthD() < 300 && !c->getLevel()->getSquare(v)->isCovered())
           c->remember(v, c->getLevel()->getSquare(v)->getViewObject());*/
@@ -92,14 +93,27 @@ class TowerTopLocation : public Location {
 
   template <class Archive>
   void serialize(Archive& ar, const unsigned int version) {
-    ar & SUBCLASS(Location) & SVAR(entered);
+    ar & SUBCLASS(Location);
+    if (version == 0) {
+      unordered_set<Creature*> oldEntered;
+      ar & boost::serialization::make_nvp("entered", oldEntered);
+      Serialization::afterLoad([=] {
+        for (Creature* c : oldEntered)
+          entered.insert(c);
+      });
+      SKIP_SERIAL(entered);
+    } else
+      ar & SVAR(entered);
     CHECK_SERIAL;
   }
 
   private:
-  unordered_set<Creature*> SERIAL(entered);
+  EntitySet<Creature> SERIAL(entered);
 };
 
+// Version 1 keeps ids of the creatures that entered.
+BOOST_CLASS_VERSION(TowerTopLocation, 1)
+
 Location* Location::towerTopLocation() {
   return new TowerTopLocation();
 }
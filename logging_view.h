@@ -30,44 +30,44 @@ class LoggingView : public T {
 
     virtual int getTimeMilli() override {
       int res = T::getTimeMilli();
-      output << "getTime" << res;
+      output << string("getTime") << res;
       return res;
     }
 
     virtual bool isClockStopped() override {
       bool res = T::isClockStopped();
-      output << "isClockStopped" << res;
+      output << string("isClockStopped") << res;
       return res;
     }
     
     virtual UserInput getAction() override {
       UserInput res = T::getAction();
-      output << "getAction" << res;
+      output << string("getAction") << res;
       return res;
     }
 
     virtual Optional<int> chooseFromList(const string& title, const vector<View::ListElem>& options, int index,
         View::MenuType type, int* scrollPos, Optional<UserInputId> action) override {
       auto res = T::chooseFromList(title, options, index, type, scrollPos, action);
-      output << "chooseFromList" << res;
+      output << string("chooseFromList") << res;
       return res;
     }
 
     virtual Optional<Vec2> chooseDirection(const string& message) override {
       auto res = T::chooseDirection(message);
-      output << "chooseDirection" << res;
+      output << string("chooseDirection") << res;
       return res;
     }
 
     virtual bool yesOrNoPrompt(const string& message) override {
       auto res = T::yesOrNoPrompt(message);
-      output << "yesOrNoPrompt" << res;
+      output << string("yesOrNoPrompt") << res;
       return res;
     }
 
     virtual Optional<int> getNumber(const string& title, int min, int max, int increments) override {
       auto res = T::getNumber(title, min, max, increments);
-      output << "getNumber" << res;
+      output << string("getNumber") << res;
       return res;
     }
   private:
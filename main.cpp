@@ -23,7 +23,8 @@
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/iostreams/copy.hpp>
 #include <boost/program_options.hpp>
-#include "gzstream.h"
+#include "compressed_stream.h"
+#include "save_header.h"
 
 #include "dirent.h"
 
@@ -45,6 +46,7 @@
 #include "script_context.h"
 #include "tile.h"
 #include "window_view.h"
+#include "replay_view.h"
 #include "clock.h"
 
 using namespace boost::iostreams;
@@ -54,9 +56,10 @@ using namespace boost::archive;
 struct SaveFileInfo {
   string path;
   time_t date;
+  Optional<SaveHeader> header;
 };
 
-static vector<SaveFileInfo> getSaveFiles(const string& suffix) {
+static vector<SaveFileInfo> getSaveFiles(const string& suffix, SaveIndex& index) {
   vector<SaveFileInfo> ret;
   struct dirent *ent;
   DIR* dir = opendir(".");
@@ -66,7 +69,7 @@ static vector<SaveFileInfo> getSaveFiles(const string& suffix) {
     if (endsWith(name, suffix)) {
       struct stat buf;
       stat(name.c_str(), &buf);
-      ret.push_back({name, buf.st_mtime});
+      ret.push_back({name, buf.st_mtime, index.getHeader(name, buf.st_mtime, buf.st_size)});
     }
   }
   closedir(dir);
@@ -96,17 +99,23 @@ static Optional<string> chooseSaveFile(vector<pair<GameType, string>> games, str
   vector<View::ListElem> options;
   bool noGames = true;
   vector<SaveFileInfo> allFiles;
+  SaveIndex index("saves.idx");
   for (auto elem : games) {
-    vector<SaveFileInfo> files = getSaveFiles(getSaveSuffix(elem.first));
+    vector<SaveFileInfo> files = getSaveFiles(getSaveSuffix(elem.first), index);
     append(allFiles, files);
     if (!files.empty()) {
       noGames = false;
-      auto removeSuf = [&] (const SaveFileInfo& s) { return s.path.substr(0, s.path.size() - 
-          getSaveSuffix(elem.first).size()) + "  (" + getDateString(s.date) + ")"; };
+      auto getName = [&] (const SaveFileInfo& s) {
+        string ret = s.path.substr(0, s.path.size() - getSaveSuffix(elem.first).size()) + "  (";
+        if (s.header)
+          ret += "turn " + convertToString(s.header->gameTime) + ", "
+              + convertToString(s.header->numCreatures) + " creatures, ";
+        return ret + getDateString(s.date) + ")"; };
       options.emplace_back(elem.second, View::TITLE);
-      append(options, View::getListElem(transform2<string>(files, removeSuf)));
+      append(options, View::getListElem(transform2<string>(files, getName)));
     }
   }
+  index.save();
   if (noGames) {
     view->presentText("", noSaveMsg);
     return Nothing();
@@ -121,7 +130,8 @@ static Optional<string> chooseSaveFile(vector<pair<GameType, string>> games, str
 template <class T, class U>
 class StreamCombiner {
   public:
-  StreamCombiner(const string& filename) : stream(filename.c_str()), archive(stream) {
+  template <class... Args>
+  StreamCombiner(const string& filename, Args... args) : stream(filename, args...), archive(stream) {
     CHECK(stream.good()) << "File not found: " << filename;
   }
 
@@ -129,20 +139,29 @@ class StreamCombiner {
     return archive;
   }
 
+  T& getStream() {
+    return stream;
+  }
+
   private:
   T stream;
   U archive;
 };
 
-typedef StreamCombiner<ofstream, binary_oarchive> CompressedOutput;
-typedef StreamCombiner<ifstream, binary_iarchive> CompressedInput;
+typedef StreamCombiner<CompressedOutputStream, binary_oarchive> CompressedOutput;
+typedef StreamCombiner<CompressedInputStream, binary_iarchive> CompressedInput;
 
 static unique_ptr<Model> loadGame(const string& filename, bool eraseFile) {
   unique_ptr<Model> model;
+  Optional<SaveHeader> header = SaveHeader::read(filename);
+  if (header)
+    CHECK(header->version <= SaveHeader::currentVersion) << "Save file is from a newer version: " << filename;
   {
-    CompressedInput input(filename.c_str());
+    CompressedInput input(filename, header ? SaveHeader::size : 0);
     Serialization::registerTypes(input.getArchive());
     input.getArchive() >> BOOST_SERIALIZATION_NVP(model);
+    if (header)
+      CHECK(input.getStream().close() == header->checksum) << "Save file is corrupted: " << filename;
   }
 #ifdef RELEASE
   if (eraseFile && !Options::getValue(OptionId::KEEP_SAVEFILES))
@@ -151,12 +170,86 @@ static unique_ptr<Model> loadGame(const string& filename, bool eraseFile) {
   return model;
 }
 
-static void saveGame(unique_ptr<Model> model, const string& filename) {
-  CompressedOutput out(filename.c_str());
-  Serialization::registerTypes(out.getArchive());
-  out.getArchive() << BOOST_SERIALIZATION_NVP(model);
+static SaveHeader getSaveHeader(const Model& model, GameType type) {
+  SaveHeader header;
+  header.gameType = type;
+  header.identifier = model.getGameIdentifier().substr(0, SaveHeader::maxIdentifierLength);
+  header.gameTime = model.getTime();
+  header.numCreatures = model.getNumCreatures();
+  return header;
 }
 
+static void saveGame(unique_ptr<Model> model, const string& filename, GameType type) {
+  SaveHeader header = getSaveHeader(*model, type);
+  {
+    CompressedOutput out(filename, CompressedOutputStream::defaultLevel, SaveHeader::size);
+    Serialization::registerTypes(out.getArchive());
+    out.getArchive() << BOOST_SERIALIZATION_NVP(model);
+    header.checksum = out.getStream().close();
+  }
+  header.write(filename);
+}
+
+const static vector<int> autosaveIntervals {0, 500, 1000, 2000};
+
+/** Saves the game periodically. The model is serialized into memory between turns, which is the only time
+ the game waits, and a worker thread compresses and writes it.*/
+class Autosaver {
+  public:
+  void update(const unique_ptr<Model>& model) {
+    int turn = model->getTime();
+    if (lastSave == -1)
+      lastSave = turn;
+    if (turn < lastSave + autosaveIntervals[1] || writing)
+      return;
+    int interval = autosaveIntervals[Options::getValue(OptionId::AUTOSAVE_INTERVAL)];
+    if (interval == 0 || turn < lastSave + interval)
+      return;
+    lastSave = turn;
+    if (worker.joinable())
+      worker.join();
+    GameType type = model->getGameType();
+    int numKept = Options::getValue(OptionId::AUTOSAVE_COUNT) + 1;
+    string path = model->getGameIdentifier() + "_autosave" + convertToString(numSaved++ % numKept)
+        + getSaveSuffix(type);
+    std::ostringstream data(std::ios::out | std::ios::binary);
+    {
+      binary_oarchive archive(data);
+      Serialization::registerTypes(archive);
+      archive << BOOST_SERIALIZATION_NVP(model);
+    }
+    writing = true;
+    worker = thread([this, path] (SaveHeader header, string data) {
+        string tmpPath = path + ".tmp";
+        try {
+          {
+            CompressedOutputStream output(tmpPath, CompressedOutputStream::defaultLevel, SaveHeader::size);
+            output.write(data.data(), data.size());
+            header.checksum = output.close();
+          }
+          header.write(tmpPath);
+          // Replace the previous autosave only when the new one is complete.
+          remove(path.c_str());
+          rename(tmpPath.c_str(), path.c_str());
+        } catch (string s) {
+          Debug() << "Autosave failed: " << s;
+        }
+        writing = false;
+    }, getSaveHeader(*model, type), data.str());
+  }
+
+  ~Autosaver() {
+    if (worker.joinable())
+      worker.join();
+  }
+
+  private:
+  int lastSave = -1;
+  int numSaved = 0;
+  thread worker;
+  std::atomic<bool> writing {false};
+};
+
 /*static Table<bool> readSplashTable(const string& path) {
   ifstream in(path);
   int x, y;
@@ -192,15 +285,142 @@ void clearAndInitialize() {
   Epithet::init();
 }
 
+/** Embeds a snapshot of the game and of the random generator in the replay log every few hundred turns, so that
+ a replay can start close to any turn without simulating everything before it. Checkpoints are written and read
+ at the same point between turns, so they stay in step with the view calls around them.*/
+class ReplayCheckpoints {
+  public:
+  ReplayCheckpoints(binary_oarchive* out, binary_iarchive* in, int startTurn)
+      : output(out), input(in), lastTurn(startTurn) {}
+
+  void update(const unique_ptr<Model>& model, double totTime) {
+    int turn = model->getTime();
+    if (turn < lastTurn + interval)
+      return;
+    lastTurn = turn;
+    if (output) {
+      std::ostringstream data(std::ios::out | std::ios::binary);
+      {
+        binary_oarchive archive(data);
+        Serialization::registerTypes(archive);
+        archive << BOOST_SERIALIZATION_NVP(model) << BOOST_SERIALIZATION_NVP(Random)
+            << BOOST_SERIALIZATION_NVP(totTime);
+      }
+      *output << string("checkpoint") << turn << data.str();
+    }
+    if (input) {
+      string method;
+      int loggedTurn;
+      string data;
+      *input >> method >> loggedTurn >> data;
+      CHECKEQ(method, "checkpoint");
+      CHECKEQ(loggedTurn, turn);
+    }
+  }
+
+  /** Reads a replay log to the end and returns how many of its checkpoints are at or before the given turn.*/
+  static int countCheckpoints(binary_iarchive& log, int turn) {
+    int ret = 0;
+    while (1) {
+      string method;
+      try {
+        log >> method;
+      } catch (const boost::archive::archive_exception&) {
+        return ret;
+      }
+      if (method != "checkpoint") {
+        skipReplayEntry(log, method);
+        continue;
+      }
+      int loggedTurn;
+      string data;
+      log >> loggedTurn >> data;
+      if (loggedTurn > turn)
+        return ret;
+      ++ret;
+    }
+  }
+
+  /** Skips the replay to the given checkpoint, counting from one, and loads the game from it.*/
+  unique_ptr<Model> seek(int checkpoint, double& totTime) {
+    CHECK(checkpoint > 0);
+    while (1) {
+      string method;
+      *input >> method;
+      if (method != "checkpoint") {
+        skipReplayEntry(*input, method);
+        continue;
+      }
+      int loggedTurn;
+      string data;
+      *input >> loggedTurn >> data;
+      if (--checkpoint == 0) {
+        Debug() << "Replaying from checkpoint at turn " << loggedTurn;
+        lastTurn = loggedTurn;
+        clearAndInitialize();
+        unique_ptr<Model> model;
+        std::istringstream in(data, std::ios::in | std::ios::binary);
+        binary_iarchive archive(in);
+        Serialization::registerTypes(archive);
+        archive >> BOOST_SERIALIZATION_NVP(model) >> BOOST_SERIALIZATION_NVP(Random)
+            >> BOOST_SERIALIZATION_NVP(totTime);
+        return model;
+      }
+    }
+  }
+
+  private:
+  const static int interval = 500;
+  binary_oarchive* output;
+  binary_iarchive* input;
+  int lastTurn;
+};
+
+static void renderBenchmark(const string& filename, int numFrames) {
+  WindowView view;
+  ScriptContext::init();
+  Tile::initialize();
+  view.initializeHeadless(1024, 600);
+  clearAndInitialize();
+  unique_ptr<Model> model = loadGame(filename, false);
+  model->setView(&view);
+  const CreatureView* creatureView = model->getCreatureView();
+  CHECK(creatureView) << "Nothing to render in " << filename;
+  WindowView::RenderStats stats = view.benchmarkRendering(creatureView, numFrames);
+  std::cout << "Frames: " << stats.frames << endl
+      << "Draw calls per frame: " << stats.commandsPerFrame << endl
+      << "Vertices per frame: " << stats.verticesPerFrame << endl
+      << "Milliseconds per frame: " << stats.millisPerFrame << " (max " << stats.maxMillis << ")" << endl;
+}
+
+static void saveReport(const string& filename, const string& reportFile) {
+  clearAndInitialize();
+  unique_ptr<Model> model = loadGame(filename, false);
+  SerialProfiler profiler;
+  {
+    binary_oarchive archive(profiler.getStream());
+    Serialization::registerTypes(archive);
+    archive << BOOST_SERIALIZATION_NVP(model);
+  }
+  ofstream out(reportFile);
+  profiler.printReport(out);
+}
+
 int main(int argc, char* argv[]) {
   options_description options("Flags");
   options.add_options()
     ("help", "Print help")
     ("run_tests", "Run all unit tests and exit")
+    ("run_render_tests", "Run the unit tests that need a display and exit")
     ("gen_world_exit", "Exit after creating a world")
     ("force_keeper", "Skip main menu and force keeper mode")
     ("seed", value<int>(), "Use given seed")
-    ("replay", value<string>(), "Replay game from file");
+    ("replay", value<string>(), "Replay game from file")
+    ("replay_from", value<int>(), "Start the replay from the last checkpoint before the given turn")
+    ("render_benchmark", value<string>(), "Render frames of a saved game without a window, print statistics and exit")
+    ("frames", value<int>(), "Number of frames for render_benchmark")
+    ("save_report", value<string>(), "Load a saved game, write the size and time of saving every field and exit")
+    ("report_file", value<string>(), "Output file for save_report, save_report.txt by default");
   variables_map vars;
   store(parse_command_line(argc, argv, options), vars);
   if (vars.count("help")) {
@@ -211,15 +431,33 @@ int main(int argc, char* argv[]) {
     testAll();
     return 0;
   }
+  if (vars.count("run_render_tests")) {
+    testRender();
+    return 0;
+  }
   unique_ptr<View> view;
   unique_ptr<CompressedInput> input;
   unique_ptr<CompressedOutput> output;
   string lognamePref = "log";
   Debug::init();
   Options::init("options.txt");
+  if (vars.count("render_benchmark")) {
+    renderBenchmark(vars["render_benchmark"].as<string>(), vars.count("frames") ? vars["frames"].as<int>() : 100);
+    return 0;
+  }
+  if (vars.count("save_report")) {
+    saveReport(vars["save_report"].as<string>(),
+        vars.count("report_file") ? vars["report_file"].as<string>() : "save_report.txt");
+    return 0;
+  }
   int seed = vars.count("seed") ? vars["seed"].as<int>() : time(0);
   int forceMode = vars.count("force_keeper") ? 0 : -1;
   bool genExit = vars.count("gen_world_exit");
+  Optional<int> replayFrom;
+  if (vars.count("replay_from")) {
+    CHECK(vars.count("replay")) << "replay_from requires replay";
+    replayFrom = vars["replay_from"].as<int>();
+  }
   if (vars.count("replay")) {
     string fname = vars["replay"].as<string>();
     Debug() << "Reading from " << fname;
@@ -352,17 +590,33 @@ int main(int argc, char* argv[]) {
       clearAndInitialize();
       return 0;
     }
+    Autosaver autosaver;
+    ReplayCheckpoints checkpoints(output ? &output->getArchive() : nullptr, input ? &input->getArchive() : nullptr,
+        model->getTime());
     try {
       const double gameTimeStep = 0.01;
       const int stepTimeMilli = 3;
       Intervalometer meter(stepTimeMilli);
       double totTime = model->getTime();
+      if (replayFrom) {
+        // The log can't be rewound, so it's scanned separately to find where to stop.
+        CompressedInput scan(vars["replay"].as<string>());
+        if (int checkpoint = ReplayCheckpoints::countCheckpoints(scan.getArchive(), *replayFrom)) {
+          model.reset();
+          model = checkpoints.seek(checkpoint, totTime);
+          model->setView(view.get());
+        } else
+          Debug() << "No checkpoint before turn " << *replayFrom << ", replaying from the start";
+        replayFrom = Nothing();
+      }
       while (1) {
         model->update(totTime);
+        autosaver.update(model);
         if (model->isTurnBased())
           ++totTime;
         else
           totTime += min(1.0, double(meter.getCount()) * gameTimeStep);
+        checkpoints.update(model, totTime);
       }
     } 
 #ifdef RELEASE
@@ -379,7 +633,7 @@ int main(int argc, char* argv[]) {
       atomic<bool> ready(false);
       view->displaySplash(View::SAVING, ready);
       string id = model->getGameIdentifier() + getSaveSuffix(ex.type);
-      saveGame(std::move(model), id);
+      saveGame(std::move(model), id, ex.type);
       ready = true;
     }
   }
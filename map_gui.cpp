@@ -28,8 +28,8 @@
 
 using sf::Keyboard;
 
-MapGui::MapGui(const Table<Optional<ViewIndex>>& o, ClickFun leftFun, ClickFun rightFun, RefreshFun refFun)
-    : objects(o), leftClickFun(leftFun), rightClickFun(rightFun), refreshFun(refFun),
+MapGui::MapGui(ClickFun leftFun, ClickFun rightFun, RefreshFun refFun)
+    : leftClickFun(leftFun), rightClickFun(rightFun), refreshFun(refFun),
     fogOfWar(Level::getMaxBounds(), false) {
   clearCenter();
 }
@@ -41,18 +41,25 @@ static Color getFireColor() {
 }
 
 
-void MapGui::updateLayout(MapLayout* l, Rectangle levelBounds) {
-  layout = l;
-  Vec2 movePos = Vec2((center.x - mouseOffset.x) * layout->squareWidth(),
-      (center.y - mouseOffset.y) * layout->squareHeight());
+Vec2 MapGui::getLayoutPos(MapLayout* l, Optional<Vec2> newCenter, Rectangle levelBounds) const {
+  double x = newCenter ? newCenter->x : center.x;
+  double y = newCenter ? newCenter->y : center.y;
+  Vec2 movePos = Vec2((x - mouseOffset.x) * l->squareWidth(), (y - mouseOffset.y) * l->squareHeight());
   movePos.x = max(movePos.x, 0);
-  movePos.x = min(movePos.x, int(levelBounds.getKX() * layout->squareWidth()));
+  movePos.x = min(movePos.x, int(levelBounds.getKX() * l->squareWidth()));
   movePos.y = max(movePos.y, 0);
-  movePos.y = min(movePos.y, int(levelBounds.getKY() * layout->squareHeight()));
-  layout->updatePlayerPos(movePos);
+  movePos.y = min(movePos.y, int(levelBounds.getKY() * l->squareHeight()));
+  return movePos;
+}
+
+void MapGui::updateLayout(MapLayout* l, Vec2 layoutPos) {
+  layout = l;
+  layout->updatePlayerPos(layoutPos);
 }
 
 void MapGui::setSpriteMode(bool s) {
+  if (s != spriteMode)
+    mapBatchesValid = false;
   spriteMode = s;
 }
 
@@ -376,12 +383,22 @@ void MapGui::setLevelBounds(Rectangle b) {
   levelBounds = b;
 }
 
-void MapGui::updateObjects(const MapMemory* mem) {
+const ViewIndex* MapGui::getViewIndex(Vec2 wpos) const {
+  if (!objects || !wpos.inRectangle(objects->getBounds()) || !(*objects)[wpos])
+    return nullptr;
+  return &*(*objects)[wpos];
+}
+
+void MapGui::updateObjects(const Table<Optional<ViewIndex>>& o, const Table<int>& updates, int frame,
+    const MapMemory* mem) {
+  objects = &o;
+  tileUpdates = &updates;
+  objectsFrame = frame;
   lastMemory = mem;
   floorIds.clear();
   shadowed.clear();
-  for (Vec2 wpos : layout->getAllTiles(getBounds(), objects.getBounds()))
-    if (auto& index = objects[wpos]) {
+  for (Vec2 wpos : layout->getAllTiles(getBounds(), objects->getBounds()))
+    if (const ViewIndex* index = getViewIndex(wpos)) {
       if (index->hasObject(ViewLayer::FLOOR)) {
         ViewObject object = index->getObject(ViewLayer::FLOOR);
         if (object.hasModifier(ViewObject::Modifier::CASTS_SHADOW)) {
@@ -451,68 +468,137 @@ bool MapGui::isFoW(Vec2 pos) const {
   return !pos.inRectangle(Level::getMaxBounds()) || fogOfWar.getValue(pos);
 }
 
-void MapGui::render(Renderer& renderer) {
+bool MapGui::isMapCacheValid() {
+  return mapBatchesValid && mapCacheKey.layout == layout && mapCacheKey.playerPos == layout->getPlayerPos()
+      && mapCacheKey.bounds == getBounds() && mapCacheKey.levelBounds == levelBounds;
+}
+
+void MapGui::updateFogOfWar() {
+  fogOfWar.clear();
+  for (Vec2 wpos : layout->getAllTiles(getBounds(), levelBounds)) {
+    const ViewIndex* index = getViewIndex(wpos);
+    if (!index || index->noObjects())
+      fogOfWar.setValue(wpos, true);
+  }
+}
+
+void MapGui::renderTile(Renderer& renderer, Vec2 wpos, ViewLayer layer) {
   int sizeX = layout->squareWidth();
   int sizeY = layout->squareHeight();
-  renderer.drawFilledRectangle(getBounds(), colors[ColorId::ALMOST_BLACK]);
-  Optional<ViewObject> highlighted;
-  fogOfWar.clear();
-  for (ViewLayer layer : layout->getLayers()) {
-    for (Vec2 wpos : layout->getAllTiles(getBounds(), levelBounds)) {
-      Vec2 pos = layout->projectOnScreen(getBounds(), wpos);
-      if (!spriteMode && wpos.inRectangle(levelBounds))
+  Vec2 pos = layout->projectOnScreen(getBounds(), wpos);
+  if (!spriteMode && wpos.inRectangle(levelBounds))
+    renderer.drawFilledRectangle(pos.x, pos.y, pos.x + sizeX, pos.y + sizeY, colors[ColorId::BLACK]);
+  const ViewIndex* index = getViewIndex(wpos);
+  if (!index || index->noObjects()) {
+    if (layer == layout->getLayers().back()) {
+      if (wpos.inRectangle(levelBounds))
         renderer.drawFilledRectangle(pos.x, pos.y, pos.x + sizeX, pos.y + sizeY, colors[ColorId::BLACK]);
-      if (!objects[wpos] || objects[wpos]->noObjects()) {
-        if (layer == layout->getLayers().back()) {
-          if (wpos.inRectangle(levelBounds))
-            renderer.drawFilledRectangle(pos.x, pos.y, pos.x + sizeX, pos.y + sizeY, colors[ColorId::BLACK]);
-        }
-        fogOfWar.setValue(wpos, true);
-        continue;
-      }
-      const ViewIndex& index = *objects[wpos];
-      const ViewObject* object = nullptr;
-      if (spriteMode) {
-        if (index.hasObject(layer))
-          object = &index.getObject(layer);
-      } else
-        object = index.getTopObject(layout->getLayers());
-      if (object) {
-        drawObjectAbs(renderer, pos.x, pos.y, *object, sizeX, sizeY, wpos);
-        if (highlightedPos == wpos)
-          highlighted = *object;
-      }
-      if (contains({ViewLayer::FLOOR, ViewLayer::FLOOR_BACKGROUND}, layer) && highlightedPos == wpos) {
-        renderer.drawFilledRectangle(pos.x, pos.y, pos.x + sizeX, pos.y + sizeY, Color::Transparent,
-            colors[ColorId::LIGHT_GRAY]);
-      }
-      if (layer == layout->getLayers().back())
-        if (!isFoW(wpos))
-          drawFoWSprite(renderer, pos, sizeX, sizeY, {
-              !isFoW(wpos + Vec2(Dir::N)),
-              !isFoW(wpos + Vec2(Dir::S)),
-              !isFoW(wpos + Vec2(Dir::E)),
-              !isFoW(wpos + Vec2(Dir::W)),
-              isFoW(wpos + Vec2(Dir::NE)),
-              isFoW(wpos + Vec2(Dir::NW)),
-              isFoW(wpos + Vec2(Dir::SE)),
-              isFoW(wpos + Vec2(Dir::SW))});
     }
-    if (!spriteMode)
-      break;
+    return;
+  }
+  const ViewObject* object = nullptr;
+  if (spriteMode) {
+    if (index->hasObject(layer))
+      object = &index->getObject(layer);
+  } else
+    object = index->getTopObject(layout->getLayers());
+  if (object)
+    drawObjectAbs(renderer, pos.x, pos.y, *object, sizeX, sizeY, wpos);
+  if (layer == layout->getLayers().back())
+    if (!isFoW(wpos))
+      drawFoWSprite(renderer, pos, sizeX, sizeY, {
+          !isFoW(wpos + Vec2(Dir::N)),
+          !isFoW(wpos + Vec2(Dir::S)),
+          !isFoW(wpos + Vec2(Dir::E)),
+          !isFoW(wpos + Vec2(Dir::W)),
+          isFoW(wpos + Vec2(Dir::NE)),
+          isFoW(wpos + Vec2(Dir::NW)),
+          isFoW(wpos + Vec2(Dir::SE)),
+          isFoW(wpos + Vec2(Dir::SW))});
+}
+
+void MapGui::renderTileHighlights(Renderer& renderer, Vec2 wpos) {
+  if (const ViewIndex* index = getViewIndex(wpos)) {
+    Vec2 pos = layout->projectOnScreen(getBounds(), wpos);
+    for (HighlightType highlight : ENUM_ALL(HighlightType))
+      if (index->getHighlight(highlight) > 0)
+        renderer.drawFilledRectangle(pos.x, pos.y, pos.x + layout->squareWidth(), pos.y + layout->squareHeight(),
+            getHighlightColor(highlight, index->getHighlight(highlight)));
+  }
+}
+
+void MapGui::renderMap(Renderer& renderer) {
+  renderer.drawFilledRectangle(getBounds(), colors[ColorId::ALMOST_BLACK]);
+  updateFogOfWar();
+  Rectangle tiles = layout->getAllTiles(getBounds(), levelBounds);
+  for (Vec2 wpos : tiles)
+    renderTile(renderer, wpos, layout->getLayers().front());
+  for (Vec2 wpos : tiles)
+    renderTileHighlights(renderer, wpos);
+}
+
+void MapGui::updateMapBatches(Renderer& renderer) {
+  Rectangle tiles = layout->getAllTiles(getBounds(), levelBounds);
+  vector<ViewLayer> layers = layout->getLayers();
+  vector<Vec2> dirty;
+  if (!isMapCacheValid()) {
+    mapCacheKey = {layout, layout->getPlayerPos(), getBounds(), levelBounds};
+    mapBatchesValid = true;
+    tileBatches = Table<vector<vector<Renderer::Batch>>>(tiles, vector<vector<Renderer::Batch>>(layers.size() + 1));
+    renderer.beginBatches(backgroundBatches);
+    renderer.drawFilledRectangle(getBounds(), colors[ColorId::ALMOST_BLACK]);
+    renderer.endBatches();
+    for (Vec2 wpos : tiles)
+      dirty.push_back(wpos);
+  } else if (tileUpdates && batchesFrame < objectsFrame) {
+    // Connections, shadows and fog of war depend on the neighbours, so they are redrawn too.
+    Table<bool> marked(tiles, false);
+    for (Vec2 wpos : tiles.intersection(tileUpdates->getBounds()))
+      if ((*tileUpdates)[wpos] > batchesFrame)
+        for (Vec2 v : Rectangle(wpos - Vec2(1, 1), wpos + Vec2(2, 2)).intersection(tiles))
+          if (!marked[v]) {
+            marked[v] = true;
+            dirty.push_back(v);
+          }
   }
-  for (Vec2 wpos : layout->getAllTiles(getBounds(), levelBounds))
-    if (auto index = objects[wpos]) {
-      Vec2 pos = layout->projectOnScreen(getBounds(), wpos);
-      for (HighlightType highlight : ENUM_ALL(HighlightType))
-        if (index->getHighlight(highlight) > 0)
-          renderer.drawFilledRectangle(pos.x, pos.y, pos.x + sizeX, pos.y + sizeY,
-              getHighlightColor(highlight, index->getHighlight(highlight)));
-      if (highlightedPos == wpos) {
-        renderer.drawFilledRectangle(pos.x, pos.y, pos.x + sizeX, pos.y + sizeY, Color::Transparent,
-            colors[ColorId::LIGHT_GRAY]);
-      }
+  batchesFrame = objectsFrame;
+  if (dirty.empty())
+    return;
+  updateFogOfWar();
+  for (Vec2 wpos : dirty) {
+    for (int i : All(layers)) {
+      renderer.beginBatches(tileBatches[wpos][i]);
+      renderTile(renderer, wpos, layers[i]);
+      renderer.endBatches();
     }
+    renderer.beginBatches(tileBatches[wpos][layers.size()]);
+    renderTileHighlights(renderer, wpos);
+    renderer.endBatches();
+  }
+  mapBatches.clear();
+  Renderer::appendBatches(mapBatches, backgroundBatches);
+  for (int i : Range(layers.size() + 1))
+    for (Vec2 wpos : tiles)
+      Renderer::appendBatches(mapBatches, tileBatches[wpos][i]);
+}
+
+void MapGui::render(Renderer& renderer) {
+  if (spriteMode) {
+    updateMapBatches(renderer);
+    renderer.drawBatches(mapBatches);
+  } else
+    renderMap(renderer);
+  // The mouse highlight is drawn over the cached map, so moving the mouse doesn't invalidate it.
+  if (highlightedPos && getViewIndex(*highlightedPos)) {
+    Vec2 pos = layout->projectOnScreen(getBounds(), *highlightedPos);
+    renderer.drawFilledRectangle(pos.x, pos.y, pos.x + layout->squareWidth(), pos.y + layout->squareHeight(),
+        Color::Transparent, colors[ColorId::LIGHT_GRAY]);
+  }
+  Optional<ViewObject> highlighted;
+  if (highlightedPos)
+    if (const ViewIndex* index = getViewIndex(*highlightedPos))
+      if (const ViewObject* object = index->getTopObject(layout->getLayers()))
+        highlighted = *object;
   animations = filter(std::move(animations), [](const AnimationInfo& elem) 
       { return !elem.animation->isDone(Clock::get().getRealMillis());});
   for (auto& elem : animations)
@@ -29,8 +29,7 @@ class MapGui : public GuiElem {
   public:
   typedef function<void(Vec2)> ClickFun;
   typedef function<void()> RefreshFun;
-  MapGui(const Table<Optional<ViewIndex>>& objects, ClickFun leftClickFun, ClickFun rightClickFun,
-      RefreshFun refreshFun);
+  MapGui(ClickFun leftClickFun, ClickFun rightClickFun, RefreshFun refreshFun);
 
   virtual void render(Renderer&) override;
   virtual void onLeftClick(Vec2) override;
@@ -40,9 +39,15 @@ class MapGui : public GuiElem {
   virtual void onKeyPressed(Event::KeyEvent) override;
 
   void refreshObjects();
-  void updateObjects(const MapMemory*);
+  /** The tables must stay valid until the next call. tileUpdates holds the frame in which each tile
+      last changed, only those changed after the previous frame are redrawn.*/
+  void updateObjects(const Table<Optional<ViewIndex>>&, const Table<int>& tileUpdates, int frame,
+      const MapMemory*);
   void setLevelBounds(Rectangle bounds);
-  void updateLayout(MapLayout*, Rectangle levelBounds);
+  /** Returns the pixel position the layout should be centered at, with the current mouse drag applied.
+      If no new center is given the current one is used.*/
+  Vec2 getLayoutPos(MapLayout*, Optional<Vec2> center, Rectangle levelBounds) const;
+  void updateLayout(MapLayout*, Vec2 layoutPos);
   void setSpriteMode(bool);
   Optional<Vec2> getHighlightedTile(WindowRenderer& renderer);
   PGuiElem getHintCallback(const string&);
@@ -60,8 +65,17 @@ class MapGui : public GuiElem {
   void drawFloorBorders(Renderer& r, const EnumSet<Dir>& borders, int x, int y);
   void drawHint(Renderer& renderer, Color color, const string& text);
   void drawFoWSprite(Renderer&, Vec2 pos, int sizeX, int sizeY, EnumSet<Dir> dirs);
+  const ViewIndex* getViewIndex(Vec2 wpos) const;
+  void renderTile(Renderer&, Vec2 wpos, ViewLayer);
+  void renderTileHighlights(Renderer&, Vec2 wpos);
+  void renderMap(Renderer&);
+  void updateFogOfWar();
+  void updateMapBatches(Renderer&);
+  bool isMapCacheValid();
   MapLayout* layout;
-  const Table<Optional<ViewIndex>>& objects;
+  const Table<Optional<ViewIndex>>* objects = nullptr;
+  const Table<int>* tileUpdates = nullptr;
+  int objectsFrame = -1;
   const MapMemory* lastMemory = nullptr;
   bool spriteMode;
   Rectangle levelBounds = Rectangle(1, 1);
@@ -80,6 +94,19 @@ class MapGui : public GuiElem {
   vector<AnimationInfo> animations;
   DirtyTable<bool> fogOfWar;
   bool isFoW(Vec2 pos) const;
+  /** In sprite mode every tile is recorded into its own batches, one set per layer plus one for the
+      highlights, and only changed tiles are recorded again. They are merged into mapBatches in drawing order.*/
+  Table<vector<vector<Renderer::Batch>>> tileBatches = Table<vector<vector<Renderer::Batch>>>(0, 0);
+  vector<Renderer::Batch> backgroundBatches;
+  vector<Renderer::Batch> mapBatches;
+  int batchesFrame = -1;
+  bool mapBatchesValid = false;
+  struct {
+    MapLayout* layout;
+    Vec2 playerPos;
+    Rectangle bounds;
+    Rectangle levelBounds;
+  } mapCacheKey;
   struct {
     double x;
     double y;
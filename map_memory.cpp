@@ -19,45 +19,188 @@
 #include "level.h"
 #include "view_object.h"
 
-MapMemory::MapMemory() : table(Level::getMaxBounds()) {
+const static int chunkSize = 16;
+
+static int getNumChunks(int size) {
+  return (size + chunkSize - 1) / chunkSize;
+}
+
+MapMemory::MapMemory()
+    : chunks(getNumChunks(Level::getMaxBounds().getW()) * getNumChunks(Level::getMaxBounds().getH())) {
+}
+
+MapMemory::MapMemory(const MapMemory& other) : chunks(other.chunks.size()), descriptions(other.descriptions),
+    descriptionIndex(other.descriptionIndex) {
+  for (int i : All(chunks))
+    if (other.chunks[i])
+      chunks[i].reset(new Chunk(*other.chunks[i]));
+}
+
+template <class Archive> 
+void MapMemory::MemoryObject::serialize(Archive& ar, const unsigned int version) {
+  ar& SVAR(id)
+    & SVAR(layer)
+    & SVAR(modifiers)
+    & SVAR(attachmentDir)
+    & SVAR(enemyStatus)
+    & SVAR(attributes)
+    & SVAR(description);
+  CHECK_SERIAL;
+}
+
+SERIALIZABLE(MapMemory::MemoryObject);
+
+template <class Archive> 
+void MapMemory::Tile::serialize(Archive& ar, const unsigned int version) {
+  ar& SVAR(known)
+    & SVAR(objects)
+    & SVAR(highlights);
+  CHECK_SERIAL;
 }
 
-MapMemory::MapMemory(const MapMemory& other) : table(other.table.getWidth(), other.table.getHeight()) {
-  for (Vec2 v : table.getBounds())
-    table[v] = other.table[v];
+SERIALIZABLE(MapMemory::Tile);
+
+template <class Archive> 
+void MapMemory::Chunk::serialize(Archive& ar, const unsigned int version) {
+  ar& SVAR(tiles);
+  CHECK_SERIAL;
 }
 
+SERIALIZABLE(MapMemory::Chunk);
+
 template <class Archive> 
 void MapMemory::serialize(Archive& ar, const unsigned int version) {
-  ar & SVAR(table);
+  ar & SVAR(chunks)
+     & SVAR(descriptions);
   CHECK_SERIAL;
 }
 
 SERIALIZABLE(MapMemory);
 
+const MapMemory::Tile* MapMemory::getTile(Vec2 pos) const {
+  CHECK(pos.inRectangle(Level::getMaxBounds())) << pos;
+  int numX = getNumChunks(Level::getMaxBounds().getW());
+  if (const Chunk* chunk = chunks[pos.x / chunkSize + numX * (pos.y / chunkSize)].get())
+    return &chunk->tiles[pos.x % chunkSize + chunkSize * (pos.y % chunkSize)];
+  else
+    return nullptr;
+}
+
+MapMemory::Tile& MapMemory::getOrCreateTile(Vec2 pos) {
+  CHECK(pos.inRectangle(Level::getMaxBounds())) << pos;
+  int numX = getNumChunks(Level::getMaxBounds().getW());
+  unique_ptr<Chunk>& chunk = chunks[pos.x / chunkSize + numX * (pos.y / chunkSize)];
+  if (!chunk) {
+    chunk.reset(new Chunk());
+    chunk->tiles.resize(chunkSize * chunkSize);
+  }
+  return chunk->tiles[pos.x % chunkSize + chunkSize * (pos.y % chunkSize)];
+}
+
+int MapMemory::getDescriptionIndex(const string& description) {
+  if (descriptionIndex.size() < descriptions.size())
+    for (int i : All(descriptions))
+      descriptionIndex[descriptions[i]] = i;
+  auto iter = descriptionIndex.find(description);
+  if (iter != descriptionIndex.end())
+    return iter->second;
+  descriptions.push_back(description);
+  return descriptionIndex[description] = descriptions.size() - 1;
+}
+
+void MapMemory::addObject(Tile& tile, const ViewObject& obj) {
+  MemoryObject elem;
+  elem.id = obj.id();
+  elem.layer = obj.layer();
+  elem.modifiers = 0;
+  for (ViewObject::Modifier mod : ENUM_ALL(ViewObject::Modifier))
+    if (obj.hasModifier(mod))
+      elem.modifiers |= 1 << int(mod);
+  if (auto dir = obj.getAttachmentDir())
+    elem.attachmentDir = int(*dir);
+  else
+    elem.attachmentDir = -1;
+  if (obj.isHostile())
+    elem.enemyStatus = ViewObject::HOSTILE;
+  else if (obj.isFriendly())
+    elem.enemyStatus = ViewObject::FRIENDLY;
+  else
+    elem.enemyStatus = ViewObject::UNKNOWN;
+  for (ViewObject::Attribute attr : ENUM_ALL(ViewObject::Attribute))
+    elem.attributes[attr] = obj.getAttribute(attr);
+  elem.description = getDescriptionIndex(obj.getBareDescription());
+  for (MemoryObject& other : tile.objects)
+    if (other.layer == elem.layer) {
+      other = elem;
+      return;
+    }
+  tile.objects.push_back(elem);
+}
+
+ViewObject MapMemory::getViewObject(const MemoryObject& elem) const {
+  ViewObject ret(elem.id, elem.layer, descriptions[elem.description]);
+  for (ViewObject::Modifier mod : ENUM_ALL(ViewObject::Modifier))
+    if (elem.modifiers & (1 << int(mod)))
+      ret.setModifier(mod);
+  if (elem.attachmentDir >= 0)
+    ret.setAttachmentDir(Dir(elem.attachmentDir));
+  ret.setEnemyStatus(ViewObject::EnemyStatus(elem.enemyStatus));
+  for (ViewObject::Attribute attr : ENUM_ALL(ViewObject::Attribute))
+    ret.setAttribute(attr, elem.attributes[attr]);
+  return ret;
+}
+
 void MapMemory::addObject(Vec2 pos, const ViewObject& obj) {
-  if (!table[pos])
-    table[pos] = ViewIndex();
-  table[pos]->insert(obj);
-  table[pos]->setHighlight(HighlightType::MEMORY);
+  Tile& tile = getOrCreateTile(pos);
+  tile.known = true;
+  addObject(tile, obj);
+  tile.version = -1;
+  ++editCount;
 }
 
-void MapMemory::update(Vec2 pos, const ViewIndex& index) {
-  table[pos] = index;
-  table[pos]->setHighlight(HighlightType::MEMORY);
-  table[pos]->removeObject(ViewLayer::CREATURE);
+void MapMemory::update(Vec2 pos, const ViewIndex& index, int version) {
+  Tile& tile = getOrCreateTile(pos);
+  tile.known = true;
+  tile.objects.clear();
+  for (ViewLayer layer : ENUM_ALL(ViewLayer))
+    if (layer != ViewLayer::CREATURE && index.hasObject(layer))
+      addObject(tile, index.getObject(layer));
+  for (HighlightType highlight : ENUM_ALL(HighlightType))
+    tile.highlights[highlight] = round(index.getHighlight(highlight) * 255);
+  tile.version = version;
+}
+
+bool MapMemory::isUpToDate(Vec2 pos, int version) const {
+  const Tile* tile = getTile(pos);
+  return tile && tile->version == version;
 }
 
 void MapMemory::clearSquare(Vec2 pos) {
-  table[pos] = Nothing();
+  if (getTile(pos))
+    getOrCreateTile(pos) = Tile();
+  ++editCount;
+}
+
+int MapMemory::getEditCount() const {
+  return editCount;
 }
 
 bool MapMemory::hasViewIndex(Vec2 pos) const {
-  return table[pos];
+  const Tile* tile = getTile(pos);
+  return tile && tile->known;
 }
 
 ViewIndex MapMemory::getViewIndex(Vec2 pos) const {
-  return *table[pos];
+  const Tile* tile = getTile(pos);
+  CHECK(tile && tile->known) << "Square not remembered " << pos;
+  ViewIndex ret;
+  for (const MemoryObject& elem : tile->objects)
+    ret.insert(getViewObject(elem));
+  for (HighlightType highlight : ENUM_ALL(HighlightType))
+    if (tile->highlights[highlight] > 0)
+      ret.setHighlight(highlight, double(tile->highlights[highlight]) / 255);
+  ret.setHighlight(HighlightType::MEMORY);
+  return ret;
 }
   
 const MapMemory& MapMemory::empty() {
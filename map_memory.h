@@ -18,17 +18,22 @@
 
 #include "view_index.h"
 #include "util.h"
+#include "view_object.h"
 
-class ViewObject;
-
+/** Remembered appearance of a level. The map is split into chunks, which are allocated only when something
+    inside them is remembered, and each object is stored as a compact record instead of a full ViewObject.*/
 class MapMemory {
   public:
   MapMemory();
   MapMemory(const MapMemory&);
   void addObject(Vec2 pos, const ViewObject& obj);
-  void update(Vec2, const ViewIndex&);
+  void update(Vec2, const ViewIndex&, int version = -1);
+  /** Checks if the square was last remembered at the given version.*/
+  bool isUpToDate(Vec2, int version) const;
   void clearSquare(Vec2 pos);
   bool hasViewIndex(Vec2 pos) const;
+  /** Counts changes that weren't made through update(), and so aren't reflected in any square's version.*/
+  int getEditCount() const;
   ViewIndex getViewIndex(Vec2 pos) const;
   static const MapMemory& empty();
 
@@ -38,7 +43,54 @@ class MapMemory {
   SERIAL_CHECKER;
 
   private:
-  Table<Optional<ViewIndex>> SERIAL(table);
+  /** Everything a ViewObject holds, with the description kept as an index into descriptions.
+      The attributes are only displayed, so they are narrowed to float.*/
+  struct MemoryObject {
+    ViewId SERIAL(id);
+    ViewLayer SERIAL(layer);
+    int SERIAL(modifiers);
+    signed char SERIAL(attachmentDir);
+    signed char SERIAL(enemyStatus);
+    EnumMap<ViewObject::Attribute, float> SERIAL(attributes);
+    int SERIAL(description);
+
+    template <class Archive> 
+    void serialize(Archive& ar, const unsigned int version);
+
+    SERIAL_CHECKER;
+  };
+
+  struct Tile {
+    bool SERIAL2(known, false);
+    vector<MemoryObject> SERIAL(objects);
+    EnumMap<HighlightType, unsigned char> SERIAL(highlights);
+    int version = -1;
+
+    template <class Archive> 
+    void serialize(Archive& ar, const unsigned int version);
+
+    SERIAL_CHECKER;
+  };
+
+  struct Chunk {
+    vector<Tile> SERIAL(tiles);
+
+    template <class Archive> 
+    void serialize(Archive& ar, const unsigned int version);
+
+    SERIAL_CHECKER;
+  };
+
+  const Tile* getTile(Vec2) const;
+  Tile& getOrCreateTile(Vec2);
+  void addObject(Tile&, const ViewObject&);
+  ViewObject getViewObject(const MemoryObject&) const;
+  int getDescriptionIndex(const string&);
+
+  vector<unique_ptr<Chunk>> SERIAL(chunks);
+  vector<string> SERIAL(descriptions);
+  map<string, int> descriptionIndex;
+  int editCount = 0;
 };
 
 #endif
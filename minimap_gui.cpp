@@ -24,9 +24,26 @@
 #include "square.h"
 
 static Image mapBuffer;
+static Texture mapTexture;
+
+static void uploadMapBuffer(Rectangle part) {
+  vector<sf::Uint8> pixels;
+  pixels.reserve(part.getW() * part.getH() * 4);
+  const sf::Uint8* buffer = mapBuffer.getPixelsPtr();
+  int width = mapBuffer.getSize().x;
+  for (int y : Range(part.getPY(), part.getKY()))
+    pixels.insert(pixels.end(), buffer + 4 * (y * width + part.getPX()), buffer + 4 * (y * width + part.getKX()));
+  mapTexture.update(pixels.data(), part.getW(), part.getH(), part.getPX(), part.getPY());
+}
 
 void MinimapGui::renderMap(Renderer& renderer, Vec2 topLeft) {
-  renderer.drawImage(info.bounds.translate(topLeft), mapBuffer, info.scale);
+  if (dirty) {
+    uploadMapBuffer(*dirty);
+    dirty = Nothing();
+  }
+  Vec2 pos = topLeft + info.bounds.getTopLeft() + (info.mapPart.getTopLeft() - info.levelPart.getTopLeft()) * info.scale;
+  renderer.drawSprite(pos.x, pos.y, info.mapPart.getPX(), info.mapPart.getPY(), info.mapPart.getW(),
+      info.mapPart.getH(), mapTexture, info.mapPart.getW() * info.scale, info.mapPart.getH() * info.scale);
   for (Vec2 v : info.roads) {
     Vec2 rrad(1, 1);
     Vec2 pos = topLeft + v * info.scale;
@@ -53,7 +70,8 @@ void MinimapGui::render(Renderer& r) {
   renderMap(r, getBounds().getTopLeft());
 }
 
-MinimapGui::MinimapGui(function<void()> f) : clickFun(f) {
+MinimapGui::MinimapGui(function<void()> f) : clickFun(f), pixelVersions(Level::getMaxBounds(), -1),
+    roads(Level::getMaxBounds(), false) {
 }
 
 void MinimapGui::onLeftClick(Vec2 v) {
@@ -62,12 +80,16 @@ void MinimapGui::onLeftClick(Vec2 v) {
 }
 
 void MinimapGui::initialize() {
-  mapBuffer.create(Level::getMaxBounds().getW(), Level::getMaxBounds().getH());
+  mapBuffer.create(Level::getMaxBounds().getW(), Level::getMaxBounds().getH(), colors[ColorId::BLACK]);
+  mapTexture.loadFromImage(mapBuffer);
 }
 
-void putMapPixel(Vec2 pos, Color col) {
-  if (pos.inRectangle(Level::getMaxBounds()))
-    mapBuffer.setPixel(pos.x, pos.y, col);
+void MinimapGui::addDirty(Vec2 pos) {
+  if (!dirty)
+    dirty = Rectangle(pos, pos + Vec2(1, 1));
+  else
+    dirty = Rectangle(min(dirty->getPX(), pos.x), min(dirty->getPY(), pos.y),
+        max(dirty->getKX(), pos.x + 1), max(dirty->getKY(), pos.y + 1));
 }
 
 void MinimapGui::update(const Level* level, Rectangle levelPart, const CreatureView* creature, bool printLocations) {
@@ -80,21 +102,34 @@ void MinimapGui::update(const Level* level, Rectangle levelPart, Rectangle bound
       double(bounds.getH()) / levelPart.getH());
   info.bounds = bounds;
   info.scale = scale;
+  info.levelPart = levelPart;
+  info.mapPart = levelPart.intersection(level->getBounds());
   info.roads.clear();
   info.enemies.clear();
   info.locations.clear();
-  for (Vec2 v : Rectangle(bounds.getW() / scale, bounds.getH() / scale)) {
-    putMapPixel(v, colors[ColorId::BLACK]);
-  }
   const MapMemory& memory = creature->getMemory();
-  for (Vec2 v : levelPart) {
-    if (!v.inRectangle(level->getBounds()) || !memory.hasViewIndex(v))
-      putMapPixel(v - levelPart.getTopLeft(), colors[ColorId::BLACK]);
-    else {
-      putMapPixel(v - levelPart.getTopLeft(), Tile::getColor(level->getSquare(v)->getViewObject()));
-      if (level->getSquare(v)->getName() == "road")
-        info.roads.push_back(v - levelPart.getTopLeft());
+  if (level != lastLevel || &memory != lastMemory) {
+    lastLevel = level;
+    lastMemory = &memory;
+    for (Vec2 v : level->getBounds())
+      pixelVersions[v] = -2;
+  }
+  // The map buffer is indexed by level coordinates and only tiles whose square changed are redrawn.
+  for (Vec2 v : info.mapPart) {
+    int version = memory.hasViewIndex(v) ? level->getSquare(v)->getVersion() : -1;
+    if (version != pixelVersions[v]) {
+      pixelVersions[v] = version;
+      if (version == -1) {
+        roads[v] = false;
+        mapBuffer.setPixel(v.x, v.y, colors[ColorId::BLACK]);
+      } else {
+        roads[v] = level->getSquare(v)->getName() == "road";
+        mapBuffer.setPixel(v.x, v.y, Tile::getColor(level->getSquare(v)->getViewObject()));
+      }
+      addDirty(v);
     }
+    if (roads[v])
+      info.roads.push_back(v - levelPart.getTopLeft());
   }
   info.player = bounds.getTopLeft() + (creature->getPosition() - levelPart.getTopLeft()) * scale;
   for (const Creature* c : creature->getVisibleEnemies()) {
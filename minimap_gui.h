@@ -21,6 +21,7 @@
 
 class Level;
 class CreatureView;
+class MapMemory;
 class WindowRenderer;
 
 class MinimapGui : public GuiElem {
@@ -42,9 +43,12 @@ class MinimapGui : public GuiElem {
   private:
 
   void renderMap(Renderer&, Vec2 topLeft);
+  void addDirty(Vec2 pos);
 
   struct MinimapInfo {
     Rectangle bounds;
+    Rectangle levelPart;
+    Rectangle mapPart;
     vector<Vec2> roads;
     vector<Vec2> enemies;
     Vec2 player;
@@ -57,6 +61,13 @@ class MinimapGui : public GuiElem {
   } info;
 
   function<void()> clickFun;
+  /** Square versions that the map buffer pixels were drawn from, or -1 for unknown squares.*/
+  Table<int> pixelVersions;
+  Table<bool> roads;
+  const Level* lastLevel = nullptr;
+  const MapMemory* lastMemory = nullptr;
+  /** Part of the map buffer that changed since it was last uploaded to the texture.*/
+  Optional<Rectangle> dirty;
 };
 
 #endif
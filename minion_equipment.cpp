@@ -94,6 +94,14 @@ void MinionEquipment::discard(const Item* it) {
   owners.erase(it->getUniqueId());
 }
 
+void MinionEquipment::discard(const Creature* c) {
+  for (auto it = owners.begin(); it != owners.end();)
+    if (it->second == c)
+      it = owners.erase(it);
+    else
+      ++it;
+}
+
 void MinionEquipment::own(const Creature* c, const Item* it) {
   owners[it->getUniqueId()] = c;
 }
@@ -107,3 +115,38 @@ int MinionEquipment::getItemValue(const Item* it) const {
     + it->getModifier(ModifierType::DEFENSE);
 }
 
+void MinionEquipment::indexItem(const Item* it, Vec2 pos) {
+  if (auto type = getEquipmentType(it)) {
+    unindexItem(it->getUniqueId());
+    indexInfo[it->getUniqueId()] = {*type, getItemValue(it), pos};
+    itemIndex[*type].insert({-getItemValue(it), it->getUniqueId()});
+  }
+}
+
+void MinionEquipment::unindexItem(UniqueEntity<Item>::Id id) {
+  if (indexInfo.count(id)) {
+    const IndexInfo& info = indexInfo.at(id);
+    itemIndex[info.type].erase({-info.value, id});
+    indexInfo.erase(id);
+  }
+}
+
+void MinionEquipment::visitIndexedItems(Optional<EquipmentType> type, function<bool(IndexedItem)> visit) {
+  typedef set<pair<int, UniqueEntity<Item>::Id>>::iterator Iter;
+  vector<pair<Iter, Iter>> ranges;
+  for (auto& elem : itemIndex)
+    if (!type || elem.first == *type)
+      ranges.push_back({elem.second.begin(), elem.second.end()});
+  // Merges the per type indexes. The iterator is moved past an item before visiting it, so that it can be erased.
+  while (1) {
+    pair<Iter, Iter>* next = nullptr;
+    for (auto& range : ranges)
+      if (range.first != range.second && (!next || *range.first < *next->first))
+        next = &range;
+    if (!next)
+      return;
+    UniqueEntity<Item>::Id id = (next->first++)->second;
+    if (!visit({id, indexInfo.at(id).pos}))
+      return;
+  }
+}
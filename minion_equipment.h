@@ -24,12 +24,15 @@ class Item;
 
 class MinionEquipment {
   public:
+  enum EquipmentType { ARMOR, HEALING, ARCHERY, COMBAT_ITEM };
 
+  static Optional<EquipmentType> getEquipmentType(const Item* it);
   bool isItemUseful(const Item*) const;
   bool needs(const Creature* c, const Item* it, bool noLimit = false, bool replacement = false) const;
   const Creature* getOwner(const Item*) const;
   void own(const Creature*, const Item*);
   void discard(const Item*);
+  void discard(const Creature*);
 
   template <class Archive>
   void serialize(Archive& ar, const unsigned int version);
@@ -38,14 +41,26 @@ class MinionEquipment {
 
   int getItemValue(const Item*) const;
 
-  private:
-  enum EquipmentType { ARMOR, HEALING, ARCHERY, COMBAT_ITEM };
+  /** Index of equipment lying around, ordered by value. The caller checks if the items are still there.*/
+  void indexItem(const Item*, Vec2 pos);
+  void unindexItem(UniqueEntity<Item>::Id);
+  typedef pair<UniqueEntity<Item>::Id, Vec2> IndexedItem;
+  /** Calls visit on indexed items of the given type, or of all types, most valuable first, until it returns false.
+   visit may unindex the item it was given, so the index isn't const.*/
+  void visitIndexedItems(Optional<EquipmentType>, function<bool(IndexedItem)> visit);
 
-  static Optional<EquipmentType> getEquipmentType(const Item* it);
+  private:
   int getEquipmentLimit(EquipmentType type) const;
   bool isItemAppropriate(const Creature*, const Item*) const;
 
   map<UniqueEntity<Creature>::Id, const Creature*> SERIAL(owners);
+  struct IndexInfo {
+    EquipmentType type;
+    int value;
+    Vec2 pos;
+  };
+  map<UniqueEntity<Item>::Id, IndexInfo> indexInfo;
+  map<EquipmentType, set<pair<int, UniqueEntity<Item>::Id>>> itemIndex;
 };
 
 #endif
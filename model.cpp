@@ -39,8 +39,12 @@ void Model::serialize(Archive& ar, const unsigned int version) {
     & SVAR(collectives)
     & SVAR(villageControls)
     & SVAR(timeQueue)
-    & SVAR(deadCreatures)
-    & SVAR(lastTick)
+    & SVAR(deadCreatures);
+  if (version == 0)
+    SKIP_SERIAL(tombstones);
+  else
+    ar & SVAR(tombstones);
+  ar& SVAR(lastTick)
     & SVAR(levelLinks)
     & SVAR(playerControl)
     & SVAR(won)
@@ -54,10 +58,31 @@ void Model::serialize(Archive& ar, const unsigned int version) {
   Technology::serializeAll(ar);
   Vision::serializeAll(ar);
   Statistics::serialize(ar, version);
+  Serialization::runAfterLoad();
+  // Old saves kept every dead creature. They are destroyed at the first tick, like the ones that just died.
+  if (version == 0)
+    for (PCreature& c : deadCreatures)
+      addTombstone(c.get());
   updateSunlightInfo();
+  creaturesById.clear();
+  for (Creature* c : timeQueue.getAllCreatures())
+    creaturesById[c->getUniqueId()] = c;
+  for (PCreature& c : deadCreatures)
+    creaturesById[c->getUniqueId()] = c.get();
 }
 
 SERIALIZABLE(Model);
+
+template <class Archive>
+void Model::Tombstone::serialize(Archive& ar, const unsigned int version) {
+  ar& BOOST_SERIALIZATION_NVP(id)
+    & BOOST_SERIALIZATION_NVP(name)
+    & BOOST_SERIALIZATION_NVP(viewId)
+    & BOOST_SERIALIZATION_NVP(tribe)
+    & BOOST_SERIALIZATION_NVP(killer);
+}
+
+SERIALIZABLE(Model::Tombstone);
 SERIALIZATION_CONSTRUCTOR_IMPL(Model);
 
 bool Model::isTurnBased() {
@@ -121,6 +146,14 @@ const Creature* Model::getPlayer() const {
   return nullptr;
 }
 
+const CreatureView* Model::getCreatureView() const {
+  if (const Creature* player = getPlayer())
+    return player;
+  if (playerControl && !playerControl->isRetired())
+    return playerControl;
+  return nullptr;
+}
+
 void Model::update(double totalTime) {
   if (addHero) {
     CHECK(playerControl && playerControl->isRetired());
@@ -189,6 +222,7 @@ void Model::update(double totalTime) {
 }
 
 void Model::tick(double time) {
+  discardDeadCreatures();
   auto previous = sunlightInfo.state;
   updateSunlightInfo();
   if (previous != sunlightInfo.state)
@@ -218,6 +252,7 @@ void Model::tick(double time) {
 
 void Model::addCreature(PCreature c) {
   c->setTime(timeQueue.getCurrentTime() + 1);
+  creaturesById[c->getUniqueId()] = c.get();
   timeQueue.addCreature(std::move(c));
 }
 
@@ -225,8 +260,45 @@ void Model::removeCreature(Creature* c) {
   deadCreatures.push_back(timeQueue.removeCreature(c));
 }
 
+void Model::addTombstone(const Creature* c) {
+  tombstones[c->getUniqueId()] = {c->getUniqueId(), c->getName(), c->getViewObject().id(), c->getTribe(),
+      c->getLastAttacker()};
+}
+
+// A creature can die during its own move, so it's destroyed only at the next tick.
+void Model::discardDeadCreatures() {
+  vector<PCreature> discarded;
+  discarded.swap(deadCreatures);
+  for (PCreature& c : discarded) {
+    addTombstone(c.get());
+    creaturesById.erase(c->getUniqueId());
+    GlobalEvents.addDiscardCreatureEvent(c.get());
+  }
+  // Collectives cancel tasks of the discarded creatures, which unregisters event handlers,
+  // so it's done after the events are dispatched.
+  for (PCollective& col : collectives)
+    for (PCreature& c : discarded)
+      col->onCreatureDiscarded(c.get());
+}
+
+const Creature* Model::getCreature(UniqueEntity<Creature>::Id id) const {
+  auto iter = creaturesById.find(id);
+  if (iter != creaturesById.end())
+    return iter->second;
+  else
+    return nullptr;
+}
+
+const Model::Tombstone* Model::getTombstone(UniqueEntity<Creature>::Id id) const {
+  if (tombstones.count(id))
+    return &tombstones.at(id);
+  else
+    return nullptr;
+}
+
 Level* Model::buildLevel(Level::Builder&& b, LevelMaker* maker) {
   Level::Builder builder(std::move(b));
+  RandomStream stream(Random.getSeed());
   levels.push_back(builder.build(this, maker));
   return levels.back().get();
 }
@@ -301,11 +373,7 @@ void Model::exitAction() {
       }
       }
       break;
-    case SAVE:
-      if (!playerControl || playerControl->isRetired())
-        throw SaveGameException(GameType::ADVENTURER);
-      else
-        throw SaveGameException(GameType::KEEPER);
+    case SAVE: throw SaveGameException(getGameType());
     case ABANDON:
       if (view->yesOrNoPrompt("Are you sure you want to abandon your game?"))
         throw GameOverException();
@@ -337,10 +405,24 @@ string Model::getGameIdentifier() const {
     return *NOTNULL(getPlayer())->getFirstName();
 }
 
+GameType Model::getGameType() const {
+  if (!playerControl || playerControl->isRetired())
+    return GameType::ADVENTURER;
+  else
+    return GameType::KEEPER;
+}
+
+int Model::getNumCreatures() const {
+  int ret = 0;
+  for (const PLevel& l : levels)
+    ret += l->getAllCreatures().size();
+  return ret;
+}
+
 void Model::onKillEvent(const Creature* victim, const Creature* killer) {
   if (playerControl && playerControl->isRetired() && victim == playerControl->getKeeper()) {
     const Creature* c = getPlayer();
-    killedKeeper(c->getNameAndTitle(), playerControl->getKeeper()->getNameAndTitle(), NameGenerator::get(NameGeneratorId::WORLD)->getNext(), c->getKills(), c->getPoints());
+    killedKeeper(c->getNameAndTitle(), playerControl->getKeeper()->getNameAndTitle(), NameGenerator::get(NameGeneratorId::WORLD)->getNext(), c->getKills().size(), c->getPoints());
   }
 }
 
@@ -595,8 +677,8 @@ void Model::changeLevel(Level* target, Vec2 position, Creature* c) {
   }
 }
   
-void Model::conquered(const string& title, const string& land, vector<const Creature*> kills, int points) {
-  string text= "You have conquered this land. You killed " + convertToString(kills.size()) +
+void Model::conquered(const string& title, const string& land, int numKills, int points) {
+  string text= "You have conquered this land. You killed " + convertToString(numKills) +
       " innocent beings and scored " + convertToString(points) +
       " points. Thank you for playing KeeperRL alpha.\n \n";
   for (string stat : Statistics::getText())
@@ -607,10 +689,10 @@ void Model::conquered(const string& title, const string& land, vector<const Crea
   showHighscore(true);
 }
 
-void Model::killedKeeper(const string& title, const string& keeper, const string& land,
-    vector<const Creature*> kills, int points) {
+void Model::killedKeeper(const string& title, const string& keeper, const string& land, int numKills,
+    int points) {
   string text= "You have freed this land from the bloody reign of " + keeper + 
-      ". You killed " + convertToString(kills.size()) +
+      ". You killed " + convertToString(numKills) +
       " enemies and scored " + convertToString(points) +
       " points. Thank you for playing KeeperRL alpha.\n \n";
   for (string stat : Statistics::getText())
@@ -630,8 +712,11 @@ void Model::gameOver(const Creature* creature, int numKills, const string& enemi
   title += "the " + creature->getName();
   text += title;
   string killer;
-  if (const Creature* c = creature->getLastAttacker()) {
-    killer = c->getName();
+  if (auto killerId = creature->getLastAttacker()) {
+    if (const Creature* c = getCreature(*killerId))
+      killer = c->getName();
+    else if (const Tombstone* tombstone = getTombstone(*killerId))
+      killer = tombstone->name;
     text += ", killed by a " + killer;
   }
   text += ". He killed " + convertToString(numKills) 
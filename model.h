@@ -20,9 +20,12 @@
 #include "encyclopedia.h"
 #include "time_queue.h"
 #include "level_maker.h"
+#include "unique_entity.h"
 
 class PlayerControl;
+class CreatureView;
 class Level;
+class Tribe;
 
 /**
   * Main class that holds all game logic.
@@ -51,25 +54,49 @@ class Model {
   /** Adds new creature to the queue. Assumes this creature has already been added to a level. */
   void addCreature(PCreature);
 
-  /** Removes creature from the queue. Assumes it has already been removed from its level. */
+  /** Removes creature from the queue. Assumes it has already been removed from its level.
+    The creature is destroyed at the start of the next tick and only its tombstone stays. */
   void removeCreature(Creature*);
 
+  /** What is kept of a creature after it's destroyed. */
+  struct Tombstone {
+    UniqueEntity<Creature>::Id id;
+    string name;
+    ViewId viewId;
+    const Tribe* tribe;
+    Optional<UniqueEntity<Creature>::Id> killer;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int version);
+  };
+
+  /** Returns the creature if it wasn't destroyed yet, dead creatures included until the next tick. */
+  const Creature* getCreature(UniqueEntity<Creature>::Id) const;
+
+  /** Returns nullptr if the creature wasn't destroyed yet. */
+  const Tombstone* getTombstone(UniqueEntity<Creature>::Id) const;
+
   const vector<VillageControl*> getVillageControls() const;
 
   bool isTurnBased();
 
   string getGameIdentifier() const;
+  /** Type of the game when it's saved now.*/
+  GameType getGameType() const;
   void exitAction();
   double getTime() const;
+  int getNumCreatures() const;
 
   View* getView();
   void setView(View*);
 
+  /** Returns what the player currently sees, or nullptr if there is nothing to show.*/
+  const CreatureView* getCreatureView() const;
+
   void tick(double time);
   void gameOver(const Creature* player, int numKills, const string& enemiesString, int points);
-  void conquered(const string& title, const string& land, vector<const Creature*> kills, int points);
-  void killedKeeper(const string& title, const string& keeper, const string& land,
-    vector<const Creature*> kills, int points);
+  void conquered(const string& title, const string& land, int numKills, int points);
+  void killedKeeper(const string& title, const string& keeper, const string& land, int numKills, int points);
   void showHighscore(bool highlightLast = false);
   void showCredits();
   void retireCollective();
@@ -90,6 +117,8 @@ class Model {
   REGISTER_HANDLER(KillEvent, const Creature* victim, const Creature* killer);
 
   void updateSunlightInfo();
+  void discardDeadCreatures();
+  void addTombstone(const Creature*);
   PCreature makePlayer(int handicap);
   const Creature* getPlayer() const;
   void landHeroPlayer();
@@ -103,6 +132,9 @@ class Model {
   View* view;
   TimeQueue SERIAL(timeQueue);
   vector<PCreature> SERIAL(deadCreatures);
+  map<UniqueEntity<Creature>::Id, Tombstone> SERIAL(tombstones);
+  // Not saved, rebuilt after loading.
+  map<UniqueEntity<Creature>::Id, Creature*> creaturesById;
   double SERIAL2(lastTick, -1000);
   map<tuple<StairDirection, StairKey, Level*>, Level*> SERIAL(levelLinks);
   PlayerControl* SERIAL2(playerControl, nullptr);
@@ -114,4 +146,7 @@ class Model {
   double lastUpdate = -10;
 };
 
+// Version 1 keeps tombstones instead of all dead creatures.
+BOOST_CLASS_VERSION(Model, 1)
+
 #endif
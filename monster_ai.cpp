@@ -22,6 +22,7 @@
 #include "effect.h"
 #include "item.h"
 #include "creature.h"
+#include "model.h"
 
 class Behaviour {
   public:
@@ -340,6 +341,11 @@ class Fighter : public Behaviour {
       lastSeen = Nothing();
   }
 
+  REGISTER_HANDLER(DiscardCreatureEvent, const Creature* c) {
+    if (lastSeen && c == lastSeen->creature)
+      lastSeen = Nothing();
+  }
+
   REGISTER_HANDLER(ThrowEvent, const Level* l, const Creature* thrower, const Item* item, const vector<Vec2>& traj) {
     if (!creature->isHumanoid() || l != creature->getLevel())
       return;
@@ -761,8 +767,13 @@ class Summoned : public GuardTarget {
       levelChanges[from] = pos;
   }
 
+  REGISTER_HANDLER(DiscardCreatureEvent, const Creature* c) {
+    if (c == target)
+      target = nullptr;
+  }
+
   virtual MoveInfo getMove() override {
-    if (target->isDead() || creature->getTime() > dieTime) {
+    if (!target || target->isDead() || creature->getTime() > dieTime) {
       return {1.0, CreatureAction([=] {
         creature->die(nullptr, false, false);
       })};
@@ -832,6 +843,10 @@ class Thief : public Behaviour {
     return NoMove;
   }
 
+  REGISTER_HANDLER(DiscardCreatureEvent, const Creature* c) {
+    removeElementMaybe(robbed, c);
+  }
+
   SERIALIZATION_CONSTRUCTOR(Thief);
 
   template <class Archive>
@@ -936,6 +951,13 @@ MonsterAI::MonsterAI(Creature* c, const vector<Behaviour*>& beh, const vector<in
     behaviours.push_back(PBehaviour(b));
 }
 
+bool MonsterAI::isForSale(const Item* item) const {
+  if (auto id = item->getShopkeeper())
+    if (const Creature* shopkeeper = creature->getLevel()->getModel()->getCreature(*id))
+      return !shopkeeper->isDead();
+  return false;
+}
+
 void MonsterAI::makeMove() {
   vector<pair<MoveInfo, int>> moves;
   for (int i : All(behaviours)) {
@@ -945,7 +967,7 @@ void MonsterAI::makeMove() {
     if (pickItems) {
       for (auto elem : Item::stackItems(creature->getPickUpOptions())) {
         Item* item = elem.second[0];
-        if (!item->getShopkeeper() && creature->pickUp(elem.second))
+        if (!isForSale(item) && creature->pickUp(elem.second))
           moves.emplace_back(
               MoveInfo({ behaviours[i]->itemValue(item) * weights[i], creature->pickUp(elem.second)}),
               weights[i]);
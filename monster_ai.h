@@ -65,6 +65,7 @@ class MonsterAI {
   private:
   friend class MonsterAIFactory;
   MonsterAI(Creature*, const vector<Behaviour*>& behaviours, const vector<int>& weights, bool pickItems = true);
+  bool isForSale(const Item*) const;
   vector<PBehaviour> SERIAL(behaviours);
   vector<int> SERIAL(weights);
   Creature* SERIAL(creature);
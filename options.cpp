@@ -23,6 +23,8 @@ const unordered_map<OptionId, int> defaults {
   {OptionId::ASCII, 0},
   {OptionId::MUSIC, 1},
   {OptionId::KEEP_SAVEFILES, 0},
+  {OptionId::AUTOSAVE_INTERVAL, 0},
+  {OptionId::AUTOSAVE_COUNT, 1},
   {OptionId::SHOW_MAP, 0},
   {OptionId::STARTING_RESOURCE, 0},
   {OptionId::START_WITH_NIGHT, 0},
@@ -34,6 +36,8 @@ const map<OptionId, string> names {
   {OptionId::ASCII, "Unicode graphics"},
   {OptionId::MUSIC, "Music"},
   {OptionId::KEEP_SAVEFILES, "Keep save files"},
+  {OptionId::AUTOSAVE_INTERVAL, "Autosave"},
+  {OptionId::AUTOSAVE_COUNT, "Autosaves kept"},
   {OptionId::SHOW_MAP, "Show map"},
   {OptionId::STARTING_RESOURCE, "Resource bonus"},
   {OptionId::START_WITH_NIGHT, "Start with night"},
@@ -46,6 +50,8 @@ const map<OptionSet, vector<OptionId>> optionSets {
       OptionId::ASCII,
       OptionId::MUSIC,
       OptionId::KEEP_SAVEFILES,
+      OptionId::AUTOSAVE_INTERVAL,
+      OptionId::AUTOSAVE_COUNT,
 #ifndef RELEASE
       OptionId::SHOW_MAP,
 #endif
@@ -91,6 +97,8 @@ unordered_map<OptionId, vector<string>> valueNames {
   {OptionId::ASCII, { "off", "on" }},
   {OptionId::MUSIC, { "off", "on" }},
   {OptionId::KEEP_SAVEFILES, { "no", "yes" }},
+  {OptionId::AUTOSAVE_INTERVAL, { "off", "every 500 turns", "every 1000 turns", "every 2000 turns" }},
+  {OptionId::AUTOSAVE_COUNT, { "1", "2", "3", "4", "5" }},
   {OptionId::SHOW_MAP, { "no", "yes" }},
   {OptionId::STARTING_RESOURCE, { "no", "yes" }},
   {OptionId::START_WITH_NIGHT, { "no", "yes" }},
@@ -118,7 +126,7 @@ bool Options::handleOrExit(View* view, OptionSet set, int lastIndex) {
   else if (index && (*index) == optionSets.at(set).size())
     return true;
   OptionId option = optionSets.at(set)[*index];
-  setValue(option, 1 - getValue(option));
+  setValue(option, (getValue(option) + 1) % valueNames.at(option).size());
   return handleOrExit(view, set, *index);
 }
 
@@ -132,7 +140,7 @@ void Options::handle(View* view, OptionSet set, int lastIndex) {
   if (!index || (*index) == optionSets.at(set).size())
     return;
   OptionId option = optionSets.at(set)[*index];
-  setValue(option, 1 - getValue(option));
+  setValue(option, (getValue(option) + 1) % valueNames.at(option).size());
   handle(view, set, *index);
 }
 
@@ -24,6 +24,8 @@ enum class OptionId {
   ASCII,
   MUSIC,
   KEEP_SAVEFILES,
+  AUTOSAVE_INTERVAL,
+  AUTOSAVE_COUNT,
 
   SHOW_MAP,
   START_WITH_NIGHT,
@@ -35,9 +35,18 @@ void Player::serialize(Archive& ar, const unsigned int version) {
     & SVAR(travelling)
     & SVAR(travelDir)
     & SVAR(target)
-    & SVAR(lastLocation)
-    & SVAR(specialCreatures)
-    & SVAR(displayGreeting)
+    & SVAR(lastLocation);
+  if (version == 0) {
+    vector<const Creature*> oldSpecial;
+    ar & boost::serialization::make_nvp("specialCreatures", oldSpecial);
+    Serialization::afterLoad([=] {
+      for (const Creature* c : oldSpecial)
+        specialCreatures.insert(c);
+    });
+    SKIP_SERIAL(specialCreatures);
+  } else
+    ar & SVAR(specialCreatures);
+  ar& SVAR(displayGreeting)
     & SVAR(levelMemory)
     & SVAR(usedEpithets)
     & SVAR(model)
@@ -646,9 +655,9 @@ void Player::makeMove() {
     model->getView()->updateView(creature);
   }
   for (const Creature* c : creature->getVisibleEnemies()) {
-    if (c->isSpecialMonster() && !contains(specialCreatures, c)) {
+    if (c->isSpecialMonster() && !specialCreatures.contains(c)) {
       privateMessage(PlayerMessage(c->getDescription(), PlayerMessage::CRITICAL));
-      specialCreatures.push_back(c);
+      specialCreatures.insert(c);
     }
   }
   if (travelling)
@@ -737,12 +746,17 @@ void Player::makeMove() {
       break;
     }
   }
-  if (!creature->isDead())
+  if (!creature->isDead()) {
+    MapMemory& memory = (*levelMemory)[creature->getLevel()->getUniqueId()];
     for (Vec2 pos : creature->getLevel()->getVisibleTiles(creature)) {
+      const Square* square = creature->getLevel()->getSquare(pos);
+      if (memory.isUpToDate(pos, square->getVersion()))
+        continue;
       ViewIndex index;
-      creature->getLevel()->getSquare(pos)->getViewIndex(creature, index);
-      (*levelMemory)[creature->getLevel()->getUniqueId()].update(pos, index);
+      square->getViewIndex(creature, index);
+      memory.update(pos, index, square->getVersion());
     }
+  }
 }
 
 void Player::showHistory() {
@@ -861,7 +875,7 @@ class PossessedController : public Player {
     : Player(c, m, false, memory), owner(_owner), isGhost(ghost) {}
 
   void onKilled(const Creature* attacker) override {
-    if (attacker)
+    if (attacker && owner)
       owner->popController();
   }
 
@@ -870,8 +884,14 @@ class PossessedController : public Player {
       unpossess();
   }
 
+  REGISTER_HANDLER(DiscardCreatureEvent, const Creature* c) {
+    if (c == owner)
+      owner = nullptr;
+  }
+
   bool unpossess() override {
-    owner->popController();
+    if (owner)
+      owner->popController();
     if (isGhost) {
       creature->die();
       return false;
@@ -895,7 +915,8 @@ class PossessedController : public Player {
 
   void onFellAsleep() override {
     creature->die();
-    owner->popController();
+    if (owner)
+      owner->popController();
   }
 
   template <class Archive>
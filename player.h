@@ -22,6 +22,7 @@
 #include "item.h"
 #include "user_input.h"
 #include "view.h"
+#include "entity_set.h"
 
 class View;
 class Model;
@@ -105,7 +106,7 @@ class Player : public Controller {
   Vec2 SERIAL(travelDir);
   Optional<Vec2> SERIAL(target);
   const Location* SERIAL2(lastLocation, nullptr);
-  vector<const Creature*> SERIAL(specialCreatures);
+  EntitySet<Creature> SERIAL(specialCreatures);
   bool SERIAL(displayGreeting);
   bool SERIAL(adventureMode);
   vector<EpithetId> SERIAL(usedEpithets);
@@ -115,4 +116,7 @@ class Player : public Controller {
   vector<string> SERIAL(messageHistory);
 };
 
+// Version 1 keeps ids of the special creatures that were already announced.
+BOOST_CLASS_VERSION(Player, 1)
+
 #endif
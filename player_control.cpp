@@ -953,6 +953,10 @@ bool PlayerControl::staticPosition() const {
   return false;
 }
 
+int PlayerControl::getOverlayVersion() const {
+  return selectionVersion + getCollective()->getOverlayVersion();
+}
+
 int PlayerControl::getMaxSightRange() const {
   return 100000;
 }
@@ -1107,6 +1111,7 @@ void PlayerControl::processInput(View* view, UserInput input) {
           rectSelectCorner2 = input.get<Vec2>();
         } else
           rectSelectCorner = input.get<Vec2>();
+        ++selectionVersion;
         break;
     case UserInputId::BUILD:
         handleSelection(input.get<BuildingInfo>().pos(), getBuildInfo()[input.get<BuildingInfo>().building()], false);
@@ -1123,6 +1128,7 @@ void PlayerControl::processInput(View* view, UserInput input) {
         }
         rectSelectCorner = Nothing();
         rectSelectCorner2 = Nothing();
+        ++selectionVersion;
         selection = NONE;
         break;
     case UserInputId::EXIT: model->exitAction(); break;
@@ -1280,13 +1286,13 @@ double PlayerControl::getWarLevel() const {
 }
 
 void PlayerControl::addToMemory(Vec2 pos) {
-  Square* square = getLevel()->getSquare(pos);
-  if (!square->isDirty())
+  const Square* square = getLevel()->getSquare(pos);
+  MapMemory& memory = getMemory(getLevel());
+  if (memory.isUpToDate(pos, square->getVersion()))
     return;
-  square->setNonDirty();
   ViewIndex index;
   square->getViewIndex(this, index);
-  getMemory(getLevel()).update(pos, index);
+  memory.update(pos, index, square->getVersion());
 }
 
 void PlayerControl::addDeityServant(Deity* deity, Vec2 deityPos, Vec2 victimPos) {
@@ -1490,7 +1496,7 @@ void PlayerControl::addImp(Creature* c) {
 void PlayerControl::onConqueredLand(const string& name) {
   if (retired)
     return;
-  model->conquered(*getKeeper()->getFirstName() + " the Keeper", name, getCollective()->getKills(),
+  model->conquered(*getKeeper()->getFirstName() + " the Keeper", name, getCollective()->getKills().size(),
       getCollective()->getDangerLevel() + getCollective()->getPoints());
 }
 
@@ -1554,6 +1560,12 @@ void PlayerControl::onSunlightChangeEvent() {
             PlayerMessage::HIGH));
 }
 
+void PlayerControl::onDiscardCreatureEvent(const Creature* c) {
+  for (auto& elem : assaultNotifications)
+    removeElementMaybe(elem.second, c);
+  forgetVisibleCreature(c);
+}
+
 void PlayerControl::onWorshipCreatureEvent(Creature* who, const Creature* to, WorshipType type) {
   if (type == WorshipType::DESTROY_ALTAR) {
     model->getView()->presentText("", "Shrine to " + to->getName() + " has been devastated by " + who->getAName());
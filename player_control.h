@@ -52,6 +52,7 @@ class PlayerControl : public CreatureView, public CollectiveControl {
 
   virtual bool staticPosition() const override;
   virtual int getMaxSightRange() const override;
+  virtual int getOverlayVersion() const override;
   virtual void addMessage(const PlayerMessage&) override;
   virtual void onDiscoveredLocation(const Location*) override;
   void addImportantLongMessage(const string&);
@@ -101,6 +102,7 @@ class PlayerControl : public CreatureView, public CollectiveControl {
   REGISTER_HANDLER(WorshipCreatureEvent, Creature* who, const Creature* to, WorshipType);
   REGISTER_HANDLER(ConquerEvent, const VillageControl*);
   REGISTER_HANDLER(SunlightChangeEvent);
+  REGISTER_HANDLER(DiscardCreatureEvent, const Creature*);
 
   friend class KeeperControlOverride;
 
@@ -217,6 +219,7 @@ class PlayerControl : public CreatureView, public CollectiveControl {
   bool SERIAL2(showWelcomeMsg, true);
   Optional<Vec2> rectSelectCorner;
   Optional<Vec2> rectSelectCorner2;
+  int selectionVersion = 0;
   double SERIAL2(lastControlKeeperQuestion, -100);
   int SERIAL2(startImpNum, -1);
   bool SERIAL2(retired, false);
@@ -42,8 +42,9 @@ class KillTribeQuest : public Quest {
   }
 
   virtual bool isFinished() const override {
+    // The leader is removed from the tribe once it's destroyed.
     if (onlyImportant)
-      return NOTNULL(tribe->getLeader())->isDead();
+      return !tribe->getLeader() || tribe->getLeader()->isDead();
     for (const Creature* c : tribe->getMembers())
       if (!c->isDead())
         return false;
@@ -99,6 +100,10 @@ void Quest::addAdventurer(Creature* c) {
   adventurers.insert(c);
 }
 
+void Quest::onDiscardCreatureEvent(const Creature* c) {
+  adventurers.erase(c);
+}
+
 void Quest::setLocation(const Location* loc) {
   CHECK(location == nullptr) << "Attempted to set quest location for a second time";
   location = loc;
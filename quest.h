@@ -21,6 +21,7 @@
 
 #include "util.h"
 #include "singleton.h"
+#include "event.h"
 
 class Location;
 class Tribe;
@@ -49,6 +50,7 @@ class Quest : public Singleton<Quest, QuestId> {
 
   protected:
   Quest(const string& startMessage);
+  REGISTER_HANDLER(DiscardCreatureEvent, const Creature*);
 
   unordered_set<const Creature*> SERIAL(adventurers);
   const Location* SERIAL2(location, nullptr);
@@ -24,6 +24,8 @@ using namespace sf;
 Font textFont;
 Font tileFont;
 Font symbolFont;
+// Only used by getTextLength, so that the game thread can lay out the gui while the render thread draws.
+Font measureFont;
 
 EnumMap<ColorId, Color> colors;
 
@@ -36,9 +38,17 @@ vector<Vec2> Renderer::tileSize;
 Vec2 Renderer::nominalSize;
 map<string, Renderer::TileCoords> Renderer::tileCoords;
 
+const static int textLengthCacheSize = 3000;
+
 int Renderer::getTextLength(string s) {
-  Text t(s, textFont, textSize);
-  return t.getLocalBounds().width;
+  std::lock_guard<std::mutex> lock(textLengthMutex);
+  auto elem = textLengths.find(s);
+  if (elem == textLengths.end()) {
+    if (textLengths.size() >= textLengthCacheSize)
+      textLengths.clear();
+    elem = textLengths.insert(make_pair(s, Text(s, measureFont, textSize).getLocalBounds().width)).first;
+  }
+  return elem->second;
 }
 
 Font& getFont(Renderer::FontId id) {
@@ -51,10 +61,34 @@ Font& getFont(Renderer::FontId id) {
   return textFont;
 }
 
+const static int textCacheSize = 3000;
+
+Text Renderer::getText(FontId id, int size, const String& s, double* width) {
+  std::lock_guard<std::mutex> lock(textCacheMutex);
+  TextKey key(id, size, s.toUtf32());
+  auto elem = textCache.find(key);
+  if (elem == textCache.end()) {
+    if (textCache.size() >= textCacheSize) {
+      textCache.erase(textCacheUses.begin()->second);
+      textCacheUses.erase(textCacheUses.begin());
+    }
+    Text t(s, getFont(id), size);
+    // Measuring also lays out the glyphs, so the copies don't have to.
+    double w = t.getLocalBounds().width;
+    elem = textCache.insert(make_pair(key, TextCacheEntry{t, w, 0})).first;
+  } else
+    textCacheUses.erase(elem->second.lastUse);
+  elem->second.lastUse = ++textCacheCounter;
+  textCacheUses.insert(make_pair(elem->second.lastUse, key));
+  if (width)
+    *width = elem->second.width;
+  return elem->second.text;
+}
+
 void Renderer::drawText(FontId id, int size, Color color, int x, int y, String s, bool center) {
   int ox = 0;
   int oy = 0;
-  Text t(s, getFont(id), size);
+  Text t = getText(id, size, s);
   if (center) {
     sf::FloatRect bounds = t.getLocalBounds();
     ox -= bounds.left + bounds.width / 2;
@@ -62,7 +96,7 @@ void Renderer::drawText(FontId id, int size, Color color, int x, int y, String s
   }
   t.setPosition(x + ox, y + oy);
   t.setColor(color);
-  display->draw(t);
+  submitText(t);
 }
 
 void Renderer::drawText(Color color, int x, int y, string s, bool center, int size) {
@@ -95,6 +129,14 @@ void Renderer::drawImage(Rectangle r, const Image& image, double scale) {
 }
 
 void Renderer::drawImage(int px, int py, int kx, int ky, const Image& image, double scale) {
+  flush();
+  ++stats.drawCalls;
+  stats.vertices += 4;
+  if (recording || !display) {
+    if (recording)
+      recording->push_back({Command::IMAGE, nullptr, 4, ""});
+    return;
+  }
   Texture t;
   t.loadFromImage(image);
   Sprite s(t, sf::IntRect(0, 0, (kx - px) / scale, (ky - py) / scale));
@@ -110,24 +152,125 @@ void Renderer::drawSprite(Vec2 pos, Vec2 spos, Vec2 size, const Texture& t, Opti
 
 void Renderer::drawSprite(int x, int y, int px, int py, int w, int h, const Texture& t, int dw, int dh,
     Optional<Color> color) {
-  Sprite s(t, sf::IntRect(px, py, w, h));
-  s.setPosition(x, y);
-  if (color)
-    s.setColor(*color);
-  if (dw != -1)
-    s.setScale(double(dw) / w, double(dh) / h);
-  display->draw(s);
+  if (dw == -1) {
+    dw = w;
+    dh = h;
+  }
+  addQuad(&t, Vec2(x, y), Vec2(x + dw, y + dh), Vec2(px, py), Vec2(px + w, py + h),
+      color ? *color : Color(255, 255, 255));
 }
 
+const static int outlineWidth = 2;
+
 void Renderer::drawFilledRectangle(const Rectangle& t, Color color, Optional<Color> outline) {
-  RectangleShape r(Vector2f(t.getW(), t.getH()));
-  r.setPosition(t.getPX(), t.getPY());
-  r.setFillColor(color);
+  Vec2 p = t.getTopLeft();
+  Vec2 k = t.getBottomRight();
+  if (color.a > 0)
+    addQuad(nullptr, p, k, Vec2(0, 0), Vec2(0, 0), color);
   if (outline) {
-    r.setOutlineThickness(-2);
-    r.setOutlineColor(*outline);
+    int w = min(outlineWidth, min(t.getW(), t.getH()) / 2);
+    addQuad(nullptr, p, Vec2(k.x, p.y + w), Vec2(0, 0), Vec2(0, 0), *outline);
+    addQuad(nullptr, Vec2(p.x, k.y - w), k, Vec2(0, 0), Vec2(0, 0), *outline);
+    addQuad(nullptr, Vec2(p.x, p.y + w), Vec2(p.x + w, k.y - w), Vec2(0, 0), Vec2(0, 0), *outline);
+    addQuad(nullptr, Vec2(k.x - w, p.y + w), Vec2(k.x, k.y - w), Vec2(0, 0), Vec2(0, 0), *outline);
+  }
+}
+
+void Renderer::addQuad(const Texture* texture, Vec2 p, Vec2 k, Vec2 texP, Vec2 texK, Color color) {
+  sf::VertexArray* vertices;
+  if (batches) {
+    if (batches->empty() || batches->back().texture != texture || !batches->back().texts.empty())
+      batches->push_back({texture, sf::VertexArray(sf::Quads), {}});
+    vertices = &batches->back().vertices;
+  } else {
+    if (texture != pendingTexture)
+      flush();
+    pendingTexture = texture;
+    vertices = &pendingVertices;
+  }
+  vertices->append(sf::Vertex(Vector2f(p.x, p.y), color, Vector2f(texP.x, texP.y)));
+  vertices->append(sf::Vertex(Vector2f(k.x, p.y), color, Vector2f(texK.x, texP.y)));
+  vertices->append(sf::Vertex(Vector2f(k.x, k.y), color, Vector2f(texK.x, texK.y)));
+  vertices->append(sf::Vertex(Vector2f(p.x, k.y), color, Vector2f(texP.x, texK.y)));
+}
+
+void Renderer::drawVertices(const sf::VertexArray& vertices, const Texture* texture) {
+  if (recording)
+    recording->push_back({Command::VERTICES, texture, int(vertices.getVertexCount()), ""});
+  else if (display)
+    display->draw(vertices, RenderStates(texture));
+  ++stats.drawCalls;
+  stats.vertices += vertices.getVertexCount();
+}
+
+void Renderer::drawTextNow(const sf::Text& text) {
+  if (recording)
+    recording->push_back({Command::TEXT, nullptr, 0, text.getString().toAnsiString()});
+  else if (display)
+    display->draw(text);
+  ++stats.drawCalls;
+}
+
+void Renderer::submitText(const sf::Text& text) {
+  if (batches)
+    batches->push_back({nullptr, sf::VertexArray(sf::Quads), {text}});
+  else {
+    flush();
+    drawTextNow(text);
+  }
+}
+
+void Renderer::flush() {
+  if (pendingVertices.getVertexCount() > 0) {
+    drawVertices(pendingVertices, pendingTexture);
+    pendingVertices.clear();
   }
-  display->draw(r);
+}
+
+void Renderer::beginBatches(vector<Batch>& b) {
+  CHECK(!batches);
+  flush();
+  batches = &b;
+  batches->clear();
+}
+
+void Renderer::endBatches() {
+  CHECK(batches);
+  batches = nullptr;
+}
+
+void Renderer::drawBatches(const vector<Batch>& b) {
+  flush();
+  for (const Batch& batch : b)
+    if (!batch.texts.empty())
+      for (const sf::Text& text : batch.texts)
+        drawTextNow(text);
+    else
+      drawVertices(batch.vertices, batch.texture);
+}
+
+void Renderer::appendBatches(vector<Batch>& to, const vector<Batch>& from) {
+  for (const Batch& batch : from)
+    if (batch.texts.empty() && !to.empty() && to.back().texts.empty() && to.back().texture == batch.texture)
+      for (int i : Range(batch.vertices.getVertexCount()))
+        to.back().vertices.append(batch.vertices[i]);
+    else
+      to.push_back(batch);
+}
+
+void Renderer::setRecording(vector<Command>* r) {
+  flush();
+  recording = r;
+}
+
+void Renderer::finishFrame() {
+  flush();
+  frameStats = stats;
+  stats = Stats();
+}
+
+const Renderer::Stats& Renderer::getFrameStats() const {
+  return frameStats;
 }
 
 void Renderer::drawFilledRectangle(int px, int py, int kx, int ky, Color color, Optional<Color> outline) {
@@ -135,18 +278,24 @@ void Renderer::drawFilledRectangle(int px, int py, int kx, int ky, Color color,
 }
 
 int Renderer::getWidth() {
+  if (!display)
+    return size.x;
   return display->getSize().x;
 }
 
 int Renderer::getHeight() {
+  if (!display)
+    return size.y;
   return display->getSize().y;
 }
 
 void Renderer::initialize(RenderTarget* d, int width, int height) {
   display = d;
+  size = Vec2(width, height);
   CHECK(textFont.loadFromFile("Lato-Bol.ttf"));
   CHECK(tileFont.loadFromFile("Lato-Bol.ttf"));
   CHECK(symbolFont.loadFromFile("Symbola.ttf"));
+  CHECK(measureFont.loadFromFile("Lato-Bol.ttf"));
   colors[ColorId::WHITE] = Color(255, 255, 255);
   colors[ColorId::YELLOW] = Color(250, 255, 0);
   colors[ColorId::LIGHT_BROWN] = Color(210, 150, 0);
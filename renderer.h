@@ -81,6 +81,7 @@ class Renderer {
   const static int textSize = 19;
   enum FontId { TEXT_FONT, TILE_FONT, SYMBOL_FONT };
   void initialize(RenderTarget*, int width, int height);
+  /** Safe to call from the game thread, it never touches the fonts used for drawing.*/
   int getTextLength(string s);
   void drawText(FontId, int size, Color color, int x, int y, String s, bool center = false);
   void drawTextWithHotkey(Color color, int x, int y, const string& text, char key);
@@ -109,13 +110,79 @@ class Renderer {
 
   static TileCoords getTileCoords(const string&);
 
+  /** Sprites and filled rectangles are collected into vertex arrays, one per texture. Consecutive draws
+      with the same texture end up in a single draw call.*/
+  struct Batch {
+    const Texture* texture;
+    sf::VertexArray vertices;
+    vector<sf::Text> texts;
+  };
+
+  /** Until endBatches(), everything is appended to the given batches instead of being drawn. Consecutive
+      sprites using the same texture are merged into one batch.*/
+  void beginBatches(vector<Batch>&);
+  void endBatches();
+  void drawBatches(const vector<Batch>&);
+  /** Appends the batches, merging the first one into the last existing batch if they share the texture.*/
+  static void appendBatches(vector<Batch>& to, const vector<Batch>& from);
+
+  /** Sends pending sprites and rectangles to the target.*/
+  void flush();
+
+  struct Stats {
+    int drawCalls = 0;
+    int vertices = 0;
+  };
+
+  /** A draw call that was recorded instead of being sent to the target.*/
+  struct Command {
+    enum Type { VERTICES, TEXT, IMAGE };
+    Type type;
+    const Texture* texture;
+    int vertices;
+    string text;
+  };
+
+  /** While a buffer is set, draw calls are appended to it instead of reaching the target. Null stops the
+      recording. Without a target draw calls are only counted.*/
+  void setRecording(vector<Command>*);
+
+  /** Ends the frame for statistics purposes.*/
+  void finishFrame();
+  const Stats& getFrameStats() const;
+
   static vector<Texture> tiles;
   static vector<Vec2> tileSize;
   static Vec2 nominalSize;
 
   private:
+  void addQuad(const Texture*, Vec2 topLeft, Vec2 bottomRight, Vec2 texTopLeft, Vec2 texBottomRight, Color);
+  void drawVertices(const sf::VertexArray&, const Texture*);
+  void submitText(const sf::Text&);
+  void drawTextNow(const sf::Text&);
+  /** Returns the laid out text, measuring it only if it's not in the cache.*/
+  sf::Text getText(FontId, int size, const String&, double* width = nullptr);
+  typedef tuple<FontId, int, std::basic_string<sf::Uint32>> TextKey;
+  struct TextCacheEntry {
+    sf::Text text;
+    double width;
+    long long lastUse;
+  };
+  map<TextKey, TextCacheEntry> textCache;
+  map<long long, TextKey> textCacheUses;
+  long long textCacheCounter = 0;
+  std::mutex textCacheMutex;
+  unordered_map<string, int> textLengths;
+  std::mutex textLengthMutex;
   static map<string, TileCoords> tileCoords;
   RenderTarget* display = nullptr;
+  Vec2 size;
+  vector<Command>* recording = nullptr;
+  const Texture* pendingTexture = nullptr;
+  sf::VertexArray pendingVertices = sf::VertexArray(sf::Quads);
+  vector<Batch>* batches = nullptr;
+  Stats stats;
+  Stats frameStats;
 };
 
 #endif
@@ -103,4 +103,25 @@ class ReplayView : public T {
     binary_iarchive& input;
 };
 
+/** Reads and discards the result of a view call logged by LoggingView.*/
+inline void skipReplayEntry(binary_iarchive& input, const string& method) {
+  if (method == "getTime") {
+    int time;
+    input >> time;
+  } else if (method == "isClockStopped" || method == "yesOrNoPrompt") {
+    bool res;
+    input >> res;
+  } else if (method == "getAction") {
+    UserInput action;
+    input >> action;
+  } else if (method == "chooseFromList" || method == "getNumber") {
+    Optional<int> res;
+    input >> res;
+  } else if (method == "chooseDirection") {
+    Optional<Vec2> res;
+    input >> res;
+  } else
+    FAIL << "Unknown replay entry " << method;
+}
+
 #endif
@@ -0,0 +1,127 @@
+/* Copyright (C) 2013-2014 Michal Brzozowski (rusolis@poczta.fm)
+
+   This file is part of KeeperRL.
+
+   KeeperRL is free software; you can redistribute it and/or modify it under the terms of the
+   GNU General Public License as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   KeeperRL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+   even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with this program.
+   If not, see http://www.gnu.org/licenses/ . */
+
+
+#include "stdafx.h"
+#include "save_header.h"
+
+#include <sys/stat.h>
+
+const static string magic = "KEEPERRL";
+
+static void writeInt(char* buf, uint32_t value) {
+  for (int i : Range(4))
+    buf[i] = (value >> (8 * i)) & 255;
+}
+
+static uint32_t readInt(const char* buf) {
+  uint32_t ret = 0;
+  for (int i : Range(4))
+    ret |= uint32_t((unsigned char) buf[i]) << (8 * i);
+  return ret;
+}
+
+void SaveHeader::write(const string& path) const {
+  char buf[size] = {0};
+  CHECK(identifier.size() <= maxIdentifierLength) << identifier;
+  memcpy(buf, magic.data(), magic.size());
+  writeInt(buf + 8, version);
+  writeInt(buf + 12, int(gameType));
+  writeInt(buf + 16, gameTime);
+  writeInt(buf + 20, numCreatures);
+  writeInt(buf + 24, checksum);
+  writeInt(buf + 28, identifier.size());
+  memcpy(buf + 32, identifier.data(), identifier.size());
+  std::fstream out(path, std::ios::in | std::ios::out | std::ios::binary);
+  out.write(buf, size);
+  CHECK(out.good()) << "Failed writing header of " << path;
+}
+
+Optional<SaveHeader> SaveHeader::read(const string& path) {
+  char buf[size];
+  ifstream in(path, std::ios::binary);
+  in.read(buf, size);
+  if (!in.good() || string(buf, magic.size()) != magic)
+    return Nothing();
+  SaveHeader ret;
+  ret.version = readInt(buf + 8);
+  ret.gameType = GameType(readInt(buf + 12));
+  ret.gameTime = readInt(buf + 16);
+  ret.numCreatures = readInt(buf + 20);
+  ret.checksum = readInt(buf + 24);
+  int length = readInt(buf + 28);
+  if (length > maxIdentifierLength)
+    return Nothing();
+  ret.identifier = string(buf + 32, length);
+  return ret;
+}
+
+bool SaveHeader::operator == (const SaveHeader& h) const {
+  return version == h.version && gameType == h.gameType && identifier == h.identifier && gameTime == h.gameTime
+      && numCreatures == h.numCreatures && checksum == h.checksum;
+}
+
+SaveIndex::SaveIndex(const string& path) : cachePath(path) {
+  ifstream in(path);
+  string line;
+  while (getline(in, line)) {
+    std::stringstream ss(line);
+    string filePath;
+    Entry entry;
+    SaveHeader header;
+    int hasHeader, gameType;
+    if (!getline(ss, filePath, '\t') || !(ss >> entry.date >> entry.fileSize >> hasHeader >> header.version
+          >> gameType >> header.gameTime >> header.numCreatures >> header.checksum))
+      continue;
+    ss.get();
+    getline(ss, header.identifier);
+    header.gameType = GameType(gameType);
+    if (hasHeader)
+      entry.header = header;
+    entries[filePath] = entry;
+  }
+}
+
+Optional<SaveHeader> SaveIndex::getHeader(const string& path, time_t date, long fileSize) {
+  auto it = entries.find(path);
+  if (it != entries.end() && it->second.date == date && it->second.fileSize == fileSize)
+    return it->second.header;
+  Optional<SaveHeader> header = SaveHeader::read(path);
+  entries[path] = {date, fileSize, header};
+  changed = true;
+  return header;
+}
+
+void SaveIndex::save() {
+  for (auto it = entries.begin(); it != entries.end();) {
+    struct stat buf;
+    if (stat(it->first.c_str(), &buf)) {
+      it = entries.erase(it);
+      changed = true;
+    } else
+      ++it;
+  }
+  if (!changed)
+    return;
+  ofstream out(cachePath);
+  for (auto& elem : entries) {
+    Optional<SaveHeader> header = elem.second.header;
+    SaveHeader h = header.getOr(SaveHeader());
+    out << elem.first << "\t" << elem.second.date << " " << elem.second.fileSize << " " << int(!!header) << " "
+        << h.version << " " << int(h.gameType) << " " << h.gameTime << " " << h.numCreatures << " " << h.checksum
+        << "\t" << h.identifier << std::endl;
+  }
+  changed = false;
+}
@@ -0,0 +1,69 @@
+/* Copyright (C) 2013-2014 Michal Brzozowski (rusolis@poczta.fm)
+
+   This file is part of KeeperRL.
+
+   KeeperRL is free software; you can redistribute it and/or modify it under the terms of the
+   GNU General Public License as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   KeeperRL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+   even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with this program.
+   If not, see http://www.gnu.org/licenses/ . */
+
+
+#ifndef _SAVE_HEADER_H
+#define _SAVE_HEADER_H
+
+#include "util.h"
+
+/** Fixed size metadata at the start of a save file. It can be read without deserializing the model,
+ the compressed model follows it.*/
+struct SaveHeader {
+  int version = currentVersion;
+  GameType gameType = GameType::KEEPER;
+  string identifier;
+  int gameTime = 0;
+  int numCreatures = 0;
+  uint32_t checksum = 0;
+
+  /** Writes the header at the beginning of an existing file.*/
+  void write(const string& path) const;
+
+  /** Returns Nothing if the file doesn't start with a header, like saves from older versions.*/
+  static Optional<SaveHeader> read(const string& path);
+
+  bool operator == (const SaveHeader&) const;
+
+  const static int size = 128;
+  /** Version 2 keeps tombstones of dead creatures, older saves are converted when loaded.*/
+  const static int currentVersion = 2;
+  const static int maxIdentifierLength = 80;
+};
+
+/** Caches headers of save files on disk, so listing the saves doesn't have to open every file.*/
+class SaveIndex {
+  public:
+  /** Loads the cache, if the file exists.*/
+  SaveIndex(const string& cachePath);
+
+  /** Reads the header only if the file was modified since it was cached.*/
+  Optional<SaveHeader> getHeader(const string& path, time_t date, long fileSize);
+
+  /** Writes the cache back, without the files that are gone.*/
+  void save();
+
+  private:
+  struct Entry {
+    time_t date;
+    long fileSize;
+    Optional<SaveHeader> header;
+  };
+  string cachePath;
+  map<string, Entry> entries;
+  bool changed = false;
+};
+
+#endif
@@ -34,13 +34,32 @@ bool Sectors::same(Vec2 v, Vec2 w) const {
   return sectors[v] > -1 && sectors[v] == sectors[w];
 }
 
-void Sectors::add(Vec2 pos) {
-  if (sectors[pos] > -1)
-    return;
+bool Sectors::contains(Vec2 v, const set<int>& sectorIds) const {
+  return v.inRectangle(bounds) && sectors[v] > -1 && sectorIds.count(sectors[v]);
+}
+
+set<int> Sectors::getNeighbors(Vec2 pos) const {
   set<int> neighbors;
   for (Vec2 v : pos.neighbors8())
     if (v.inRectangle(bounds) && sectors[v] > -1)
       neighbors.insert(sectors[v]);
+  return neighbors;
+}
+
+bool Sectors::isConnecting(Vec2 added, Vec2 from, Vec2 to) const {
+  set<int> joined = getNeighbors(added);
+  if (joined.size() < 2 || !contains(from, joined))
+    return false;
+  for (Vec2 v : concat({to}, to.neighbors8()))
+    if (contains(v, joined) && !same(v, from))
+      return true;
+  return false;
+}
+
+void Sectors::add(Vec2 pos) {
+  if (sectors[pos] > -1)
+    return;
+  set<int> neighbors = getNeighbors(pos);
   if (neighbors.size() == 0)
     setSector(pos, getNewSector());
   else
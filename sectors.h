@@ -23,6 +23,11 @@ class Sectors {
   Sectors(Rectangle bounds);
 
   bool same(Vec2, Vec2) const;
+  bool contains(Vec2, const set<int>& sectorIds) const;
+  /** Returns the sectors that would be joined together if the square was added.*/
+  set<int> getNeighbors(Vec2) const;
+  /** Checks if adding the square would join the sector of the first position with a square next to the second.*/
+  bool isConnecting(Vec2 added, Vec2 from, Vec2 to) const;
   void add(Vec2);
   void remove(Vec2);
   void dump();
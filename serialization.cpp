@@ -15,6 +15,8 @@
 
 #include "stdafx.h"
 
+#include <chrono>
+
 #include "serialization.h"
 #include "creature_factory.h"
 #include "square_factory.h"
@@ -57,10 +59,25 @@ void Serialization::registerTypes(Archive& ar) {
   PlayerControl::registerTypes(ar);
   CollectiveControl::registerTypes(ar);
   Collective::registerTypes(ar);
+  // New types go at the end, so that older saves keep their type ids.
+  REGISTER_TYPE(ar, DoNothingController);
 }
 
 REGISTER_TYPES(Serialization);
 
+vector<function<void()>> Serialization::afterLoadFunctions;
+
+void Serialization::afterLoad(function<void()> f) {
+  afterLoadFunctions.push_back(f);
+}
+
+void Serialization::runAfterLoad() {
+  vector<function<void()>> functions;
+  functions.swap(afterLoadFunctions);
+  for (auto& f : functions)
+    f();
+}
+
 void SerialChecker::checkSerial() {
   for (Check* c : checks)
     c->tickOff();
@@ -111,3 +128,106 @@ void SerialChecker::addCheck(Check* c) {
   CHECK(!contains(checks, c));
   checks.push_back(c);
 }
+
+class SerialProfiler::Counter : public std::streambuf {
+  public:
+  long long count = 0;
+
+  virtual int overflow(int c) override {
+    ++count;
+    return traits_type::not_eof(c);
+  }
+
+  virtual std::streamsize xsputn(const char*, std::streamsize n) override {
+    count += n;
+    return n;
+  }
+};
+
+SerialProfiler* SerialProfiler::current = nullptr;
+
+SerialProfiler::SerialProfiler() : counter(new Counter()), stream(new std::ostream(counter.get())) {
+  CHECK(!current) << "Only one SerialProfiler can be active";
+  current = this;
+}
+
+SerialProfiler::~SerialProfiler() {
+  current = nullptr;
+}
+
+std::ostream& SerialProfiler::getStream() {
+  return *stream;
+}
+
+bool SerialProfiler::isActive() {
+  return current;
+}
+
+double SerialProfiler::getTime() const {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Takes the class out of __PRETTY_FUNCTION__, for example "void Level::serialize(Archive&, ...) [...]".
+static string getClassName(const char* function) {
+  string f(function);
+  f = f.substr(0, f.find('('));
+  size_t end = f.rfind("::");
+  if (end == string::npos)
+    return "";
+  size_t begin = end;
+  int depth = 0;
+  while (begin > 0) {
+    char c = f[begin - 1];
+    if (c == '>')
+      ++depth;
+    else if (c == '<')
+      --depth;
+    else if (c == ' ' && depth == 0)
+      break;
+    --begin;
+  }
+  return f.substr(begin, end - begin);
+}
+
+void SerialProfiler::enter(const char* field, const char* function) {
+  auto it = current->classNames.find(function);
+  if (it == current->classNames.end())
+    it = current->classNames.insert(make_pair(function, getClassName(function))).first;
+  current->stack.push_back({it->second + "::" + field, current->counter->count, current->getTime(), 0, 0});
+}
+
+void SerialProfiler::leave() {
+  Frame frame = current->stack.back();
+  current->stack.pop_back();
+  long long bytes = current->counter->count - frame.startBytes;
+  double time = current->getTime() - frame.startTime;
+  Entry& entry = current->entries[frame.name];
+  entry.bytes += bytes;
+  entry.ownBytes += bytes - frame.nestedBytes;
+  entry.time += time;
+  entry.ownTime += time - frame.nestedTime;
+  if (!current->stack.empty()) {
+    current->stack.back().nestedBytes += bytes;
+    current->stack.back().nestedTime += time;
+  }
+}
+
+static string getPercent(double part, double total) {
+  return convertToString(int(100 * part / max(total, 1e-9) + 0.5)) + "%";
+}
+
+void SerialProfiler::printReport(std::ostream& out) {
+  long long totalBytes = counter->count;
+  double totalTime = 0;
+  for (auto& elem : entries)
+    totalTime += elem.second.ownTime;
+  vector<pair<string, Entry>> sorted(entries.begin(), entries.end());
+  sort(sorted.begin(), sorted.end(), [](const pair<string, Entry>& a, const pair<string, Entry>& b) {
+      return a.second.ownBytes > b.second.ownBytes; });
+  out << "Total " << totalBytes << " bytes, " << int(totalTime * 1000) << " ms" << endl;
+  out << "Fields sorted by own size. Nested fields are included in the numbers after the slash." << endl;
+  for (auto& elem : sorted)
+    out << elem.first << " " << getPercent(elem.second.ownBytes, totalBytes) << "/"
+        << getPercent(elem.second.bytes, totalBytes) << " (" << elem.second.ownBytes << " bytes), time "
+        << getPercent(elem.second.ownTime, totalTime) << "/" << getPercent(elem.second.time, totalTime) << endl;
+}
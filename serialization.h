@@ -44,16 +44,20 @@
 #define SERIAL(X) X; SerialChecker::Check X##_Check = SerialChecker::Check(serialChecker)
 #define SERIAL2(X, Y) X = Y; SerialChecker::Check X##_Check = SerialChecker::Check(serialChecker)
 #define SERIAL3(X) SerialChecker::Check X##_Check = SerialChecker::Check(serialChecker);
-#define SVAR(X) boost::serialization::make_nvp(#X, checkSerial(X, X##_Check))
+#define SVAR(X) profiledNvp(#X, checkSerial(X, X##_Check), __PRETTY_FUNCTION__)
+#define SKIP_SERIAL(X) X##_Check.tick()
 #else
 #define SERIAL_CHECKER
 #define CHECK_SERIAL
 #define SERIAL(X) X
 #define SERIAL2(X, Y) X = Y
 #define SERIAL3(X)
-#define SVAR(X) boost::serialization::make_nvp(#X, X)
+#define SVAR(X) profiledNvp(#X, X, __PRETTY_FUNCTION__)
+#define SKIP_SERIAL(X)
 #endif
 
+/** SKIP_SERIAL marks a field as handled when it's missing from an archive of an older class version.*/
+
 #define SERIALIZATION_DECL(A) \
   friend boost::serialization::access; \
   A(); \
@@ -75,6 +79,14 @@ class Serialization {
   public:
   template <class Archive>
   static void registerTypes(Archive& ar);
+
+  /** Runs the function once the whole model is loaded. Loading code of older class versions uses it to read
+    unique ids of the creatures it points to, as these may be only partially loaded before.*/
+  static void afterLoad(function<void()>);
+  static void runAfterLoad();
+
+  private:
+  static vector<function<void()>> afterLoadFunctions;
 };
 
 class SerialChecker {
@@ -113,6 +125,71 @@ T& checkSerial(T& t, SerialChecker::Check& check) {
   return t;
 }
 
+/** While an instance exists, records the size and time of everything serialized through SVAR, per class
+ and field.*/
+class SerialProfiler {
+  public:
+  SerialProfiler();
+  ~SerialProfiler();
+
+  /** Discards everything written to it. The sizes are measured on this stream.*/
+  std::ostream& getStream();
+
+  /** Fields sorted by their own size, without the fields nested in them.*/
+  void printReport(std::ostream&);
+
+  static bool isActive();
+  static void enter(const char* field, const char* function);
+  static void leave();
+
+  private:
+  class Counter;
+  unique_ptr<Counter> counter;
+  unique_ptr<std::ostream> stream;
+  struct Entry {
+    long long bytes = 0;
+    long long ownBytes = 0;
+    double time = 0;
+    double ownTime = 0;
+  };
+  map<string, Entry> entries;
+  struct Frame {
+    string name;
+    long long startBytes;
+    double startTime;
+    long long nestedBytes;
+    double nestedTime;
+  };
+  vector<Frame> stack;
+  map<const char*, string> classNames;
+  double getTime() const;
+  static SerialProfiler* current;
+};
+
+template <class T>
+struct ProfiledNvp : public boost::serialization::wrapper_traits<const ProfiledNvp<T>> {
+  ProfiledNvp(const char* n, T& v, const char* f) : name(n), value(v), function(f) {}
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int) {
+    if (SerialProfiler::isActive()) {
+      SerialProfiler::enter(name, function);
+      ar & boost::serialization::make_nvp(name, value);
+      SerialProfiler::leave();
+    } else
+      ar & boost::serialization::make_nvp(name, value);
+  }
+
+  const char* name;
+  T& value;
+  const char* function;
+};
+
+template <class T>
+const ProfiledNvp<T> profiledNvp(const char* name, T& value, const char* function) {
+  return ProfiledNvp<T>(name, value, function);
+}
+
 
 
 namespace boost { 
@@ -230,12 +230,25 @@ Vec2 ShortestPath::getTarget() const {
 
 Dijkstra::Dijkstra(Rectangle bounds, Vec2 from, int maxDist, function<double(Vec2)> entryFun,
       vector<Vec2> directions) {
+  init(bounds, {from}, maxDist, entryFun, directions);
+}
+
+Dijkstra::Dijkstra(Rectangle bounds, const vector<Vec2>& from, int maxDist, function<double(Vec2)> entryFun,
+      vector<Vec2> directions) {
+  init(bounds, from, maxDist, entryFun, directions);
+}
+
+void Dijkstra::init(Rectangle bounds, const vector<Vec2>& from, int maxDist, function<double(Vec2)> entryFun,
+      const vector<Vec2>& directions) {
   distanceTable.clear();
   function<bool(Vec2, Vec2)> comparator = [&] (Vec2 pos1, Vec2 pos2) {
     return distanceTable.getDistance(pos1) > distanceTable.getDistance(pos2); };
   priority_queue<Vec2, vector<Vec2>, decltype(comparator)> q(comparator) ;
-  distanceTable.setDistance(from, 0);
-  q.push(from);
+  for (Vec2 v : from) {
+    distanceTable.setDistance(v, 0);
+    source[v] = v;
+    q.push(v);
+  }
   int numPopped = 0;
   while (!q.empty()) {
     ++numPopped;
@@ -254,6 +267,7 @@ Dijkstra::Dijkstra(Rectangle bounds, Vec2 from, int maxDist, function<double(Vec
           CHECK(dist > cdist) << "Entry fun non positive " << dist - cdist;
           if (dist < ndist) {
             distanceTable.setDistance(next, dist);
+            source[next] = source.at(pos);
             q.push(next);
           }
         }
@@ -271,6 +285,11 @@ double Dijkstra::getDist(Vec2 v) const {
   return reachable.at(v);
 }
 
+Vec2 Dijkstra::getSource(Vec2 v) const {
+  CHECK(reachable.count(v));
+  return source.at(v);
+}
+
 const map<Vec2, double>& Dijkstra::getAllReachable() const {
   return reachable;
 }
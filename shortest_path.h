@@ -59,12 +59,19 @@ class Dijkstra {
   public:
   Dijkstra(Rectangle bounds, Vec2 from, int maxDist, function<double(Vec2)> entryFun,
       vector<Vec2> directions = Vec2::directions8());
+  /** Runs a single search from many sources at once. Every reached square remembers the closest source.*/
+  Dijkstra(Rectangle bounds, const vector<Vec2>& from, int maxDist, function<double(Vec2)> entryFun,
+      vector<Vec2> directions = Vec2::directions8());
   bool isReachable(Vec2) const;
   double getDist(Vec2) const;
+  Vec2 getSource(Vec2) const;
   const map<Vec2, double>& getAllReachable() const;
   
   private:
+  void init(Rectangle bounds, const vector<Vec2>& from, int maxDist, function<double(Vec2)> entryFun,
+      const vector<Vec2>& directions);
   map<Vec2, double> reachable;
+  map<Vec2, Vec2> source;
 };
 
 #endif
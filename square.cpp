@@ -44,8 +44,7 @@ void Square::serialize(Archive& ar, const unsigned int version) {
     & SVAR(constructions)
     & SVAR(ticking)
     & SVAR(fog)
-    & SVAR(movementType)
-    & SVAR(dirty);
+    & SVAR(movementType);
   CHECK_SERIAL;
 }
 
@@ -57,6 +56,7 @@ Square::Square(const ViewObject& obj, Params p)
   : Renderable(obj), name(p.name), vision(p.vision), hide(p.canHide), strength(p.strength),
     fire(p.strength, p.flamability), constructions(p.constructions), ticking(p.ticking),
     movementType(p.movementType) {
+  setDirty();
 }
 
 Square::~Square() {
@@ -81,7 +81,7 @@ string Square::getName() const {
 }
 
 void Square::setName(const string& s) {
-  dirty = true;
+  setDirty();
   name = s;
 }
 
@@ -119,7 +119,7 @@ bool Square::canConstruct(SquareType type) const {
 }
 
 bool Square::construct(SquareType type) {
-  dirty = true;
+  setDirty();
   CHECK(canConstruct(type));
   if (--constructions[type.getId()] <= 0) {
     PSquare newSquare = PSquare(SquareFactory::get(type));
@@ -132,14 +132,14 @@ bool Square::construct(SquareType type) {
 }
 
 void Square::destroy() {
-  dirty = true;
+  setDirty();
   getLevel()->globalMessage(getPosition(), "The " + getName() + " is destroyed.");
   GlobalEvents.addSquareReplacedEvent(getLevel(), getPosition());
   getLevel()->replaceSquare(getPosition(), PSquare(SquareFactory::get(SquareId::FLOOR)));
 }
 
 void Square::burnOut() {
-  dirty = true;
+  setDirty();
   getLevel()->globalMessage(getPosition(), "The " + getName() + " burns down.");
   GlobalEvents.addSquareReplacedEvent(getLevel(), getPosition());
   getLevel()->replaceSquare(getPosition(), PSquare(SquareFactory::get(SquareId::FLOOR)));
@@ -172,12 +172,12 @@ const Level* Square::getLevel() const {
 }
 
 void Square::setFog(double val) {
-  dirty = true;
+  setDirty();
   fog = val;
 }
 
 void Square::tick(double time) {
-  dirty = true;
+  setDirty();
   if (!inventory.isEmpty())
     for (Item* item : inventory.getItems()) {
       item->tick(time, level, position);
@@ -235,7 +235,7 @@ bool Square::itemBounces(Item* item, Vision* v) const {
 }
 
 void Square::onItemLands(vector<PItem> item, const Attack& attack, int remainingDist, Vec2 dir, Vision* vision) {
-  dirty = true;
+  setDirty();
   if (creature) {
     item[0]->onHitCreature(creature, attack, item.size() > 1);
     if (!item[0]->isDiscarded())
@@ -278,7 +278,7 @@ bool Square::canEnterSpecial(const Creature* c) const {
 }
 
 void Square::setOnFire(double amount) {
-  dirty = true;
+  setDirty();
   bool burning = fire.isBurning();
   fire.set(amount);
   if (!burning && fire.isBurning()) {
@@ -293,7 +293,7 @@ void Square::setOnFire(double amount) {
 }
 
 void Square::addPoisonGas(double amount) {
-  dirty = true;
+  setDirty();
   if (canSeeThru()) {
     poisonGas.addAmount(amount);
     level->addTickingSquare(position);
@@ -313,7 +313,7 @@ Optional<ViewObject> Square::getBackgroundObject() const {
 }
 
 void Square::setBackground(const Square* square) {
-  dirty = true;
+  setDirty();
   if (getViewObject().layer() != ViewLayer::FLOOR_BACKGROUND) {
     const ViewObject& obj = square->backgroundObject ? (*square->backgroundObject) : square->getViewObject();
     if (obj.layer() == ViewLayer::FLOOR_BACKGROUND)
@@ -350,17 +350,19 @@ void Square::getViewIndex(const CreatureView* c, ViewIndex& ret) const {
 }
 
 void Square::onEnter(Creature* c) {
-  dirty = true;
+  setDirty();
   for (Trigger* t : extractRefs(triggers))
     t->onCreatureEnter(c);
   onEnterSpecial(c);
 }
 
 void Square::dropItem(PItem item) {
-  dirty = true;
-  if (level)  // if level == null, then it's being constructed, square will be added later
-    level->addTickingSquare(getPosition());
+  setDirty();
   inventory.addItem(std::move(item));
+  if (level) { // if level == null, then it's being constructed, square will be added later
+    level->addTickingSquare(getPosition());
+    GlobalEvents.addItemsLandedEvent(level, getPosition());
+  }
 }
 
 void Square::dropItems(vector<PItem> items) {
@@ -377,7 +379,7 @@ Creature* Square::getCreature() {
 }
 
 void Square::addTrigger(PTrigger t) {
-  dirty = true;
+  setDirty();
   level->addTickingSquare(position);
   Trigger* ref = t.get();
   level->addLightSource(position, t->getLightEmission());
@@ -389,7 +391,7 @@ const vector<Trigger*> Square::getTriggers() const {
 }
 
 PTrigger Square::removeTrigger(Trigger* trigger) {
-  dirty = true;
+  setDirty();
   for (PTrigger& t : triggers)
     if (t.get() == trigger) {
       PTrigger ret = std::move(t);
@@ -413,7 +415,7 @@ const Creature* Square::getCreature() const {
 }
 
 void Square::removeCreature() {
-  dirty = true;
+  setDirty();
   CHECK(creature);
   creature = 0;
 }
@@ -450,21 +452,23 @@ vector<Item*> Square::getItems(function<bool (Item*)> predicate) const {
 }
 
 PItem Square::removeItem(Item* it) {
-  dirty = true;
+  setDirty();
   return inventory.removeItem(it);
 }
 
 vector<PItem> Square::removeItems(vector<Item*> it) {
-  dirty = true;
+  setDirty();
   return inventory.removeItems(it);
 }
 
-void Square::setNonDirty() {
-  dirty = false;
+static int versionCounter = 0;
+
+void Square::setDirty() {
+  version = ++versionCounter;
 }
 
-bool Square::isDirty() const {
-  return dirty;
+int Square::getVersion() const {
+  return version;
 }
 
 void Square::setMovementType(MovementType t) {
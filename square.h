@@ -209,8 +209,9 @@ class Square : public Renderable {
 
   void setFog(double val);
 
-  bool isDirty() const;
-  void setNonDirty();
+  /** Returns a number that changes every time the square's appearance might have changed.
+      Versions are unique across all squares, so a replaced square never repeats an old version.*/
+  int getVersion() const;
 
   SERIALIZATION_DECL(Square);
 
@@ -228,6 +229,7 @@ class Square : public Renderable {
 
   private:
   Item* getTopItem() const;
+  void setDirty();
 
   Level* SERIAL2(level, nullptr);
   Vec2 SERIAL(position);
@@ -246,7 +248,7 @@ class Square : public Renderable {
   bool SERIAL(ticking);
   double SERIAL2(fog, 0);
   MovementType SERIAL(movementType);
-  bool SERIAL2(dirty, true);
+  int version = 0;
 };
 
 #endif
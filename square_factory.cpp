@@ -635,8 +635,8 @@ class Altar : public Square {
 
   REGISTER_HANDLER(KillEvent, const Creature* victim, const Creature* killer) {
     if (victim->getLevel() == getLevel() && victim->getPosition() == getPosition() && killer) {
-      recentKiller = killer;
-      recentVictim = victim;
+      recentKiller = killer->getUniqueId();
+      recentVictim = victim->getUniqueId();
       killTime = killer->getTime();
     }
   }
@@ -646,9 +646,9 @@ class Altar : public Square {
   virtual string getName() = 0;
 
   virtual void onApply(Creature* c) override {
-    if (c == recentKiller && recentVictim && killTime >= c->getTime() - sacrificeTimeout)
+    if (recentKiller == c->getUniqueId() && recentVictim && killTime >= c->getTime() - sacrificeTimeout)
       for (Item* it : getItems(Item::classPredicate(ItemClass::CORPSE)))
-        if (it->getCorpseInfo()->victim == recentVictim->getUniqueId()) {
+        if (it->getCorpseInfo()->victim == *recentVictim) {
           c->you(MsgType::SACRIFICE, getName());
           c->globalMessage(it->getTheName() + " is consumed in a flash of light!");
           removeItem(it);
@@ -661,22 +661,39 @@ class Altar : public Square {
 
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version) {
-    ar& SUBCLASS(Square)
-      & SVAR(recentKiller)
-      & SVAR(recentVictim)
-      & SVAR(killTime);
+    ar& SUBCLASS(Square);
+    if (version == 0) {
+      const Creature* oldKiller = nullptr;
+      const Creature* oldVictim = nullptr;
+      ar & boost::serialization::make_nvp("recentKiller", oldKiller)
+         & boost::serialization::make_nvp("recentVictim", oldVictim);
+      Serialization::afterLoad([=] {
+        if (oldKiller)
+          recentKiller = oldKiller->getUniqueId();
+        if (oldVictim)
+          recentVictim = oldVictim->getUniqueId();
+      });
+      SKIP_SERIAL(recentKiller);
+      SKIP_SERIAL(recentVictim);
+    } else
+      ar & SVAR(recentKiller)
+         & SVAR(recentVictim);
+    ar & SVAR(killTime);
     CHECK_SERIAL;
   }
 
   SERIALIZATION_CONSTRUCTOR(Altar);
 
   private:
-  const Creature* SERIAL2(recentKiller, nullptr);
-  const Creature* SERIAL2(recentVictim, nullptr);
+  Optional<UniqueEntity<Creature>::Id> SERIAL(recentKiller);
+  Optional<UniqueEntity<Creature>::Id> SERIAL(recentVictim);
   double SERIAL2(killTime, -100);
   const double sacrificeTimeout = 50;
 };
 
+// Version 1 refers to the killer and the victim by id.
+BOOST_CLASS_VERSION(Altar, 1)
+
 class DeityAltar : public Altar {
   public:
   DeityAltar(const ViewObject& object, Deity* d) : Altar(ViewObject(object.id(), object.layer(),
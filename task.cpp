@@ -466,7 +466,7 @@ class Kill : public NonTransferable {
   }
 
   virtual MoveInfo getMove(Creature* c) override {
-    if (creature->isDead()) {
+    if (!creature || creature->isDead()) {
       setDone();
       return NoMove;
     }
@@ -477,7 +477,13 @@ class Kill : public NonTransferable {
   }
 
   virtual void cancel() override {
-    callback->onKillCancelled(creature);
+    if (creature)
+      callback->onKillCancelled(creature);
+  }
+
+  REGISTER_HANDLER(DiscardCreatureEvent, const Creature* c) {
+    if (creature == c)
+      creature = nullptr;
   }
 
   template <class Archive> 
@@ -514,7 +520,7 @@ class Sacrifice : public NonTransferable {
   Sacrifice(Callback* call, Creature* c) : creature(c), callback(call) {}
 
   virtual MoveInfo getMove(Creature* c) override {
-    if (creature->isDead()) {
+    if (!creature || creature->isDead()) {
       if (sacrificePos) {
         if (sacrificePos == c->getPosition())
           return c->applySquare().append([=] { setDone(); });
@@ -534,7 +540,13 @@ class Sacrifice : public NonTransferable {
   }
 
   virtual void cancel() override {
-    callback->onKillCancelled(creature);
+    if (creature)
+      callback->onKillCancelled(creature);
+  }
+
+  REGISTER_HANDLER(DiscardCreatureEvent, const Creature* c) {
+    if (creature == c)
+      creature = nullptr;
   }
 
   template <class Archive> 
@@ -974,7 +986,7 @@ class Copulate : public NonTransferable {
   Copulate(Callback* c, Creature* t, int turns) : target(t), callback(c), numTurns(turns) {}
 
   virtual MoveInfo getMove(Creature* c) override {
-    if (target->isDead() || !target->isAffected(LastingEffect::SLEEP)) {
+    if (!target || target->isDead() || !target->isAffected(LastingEffect::SLEEP)) {
       setDone();
       return NoMove;
     }
@@ -996,6 +1008,11 @@ class Copulate : public NonTransferable {
       return c->moveTowards(target->getPosition());
   }
 
+  REGISTER_HANDLER(DiscardCreatureEvent, const Creature* c) {
+    if (target == c)
+      target = nullptr;
+  }
+
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version) {
     ar& SUBCLASS(NonTransferable)
@@ -1024,7 +1041,7 @@ class Consume : public NonTransferable {
   Consume(Callback* c, Creature* t) : target(t), callback(c) {}
 
   virtual MoveInfo getMove(Creature* c) override {
-    if (target->isDead()) {
+    if (!target || target->isDead()) {
       setDone();
       return NoMove;
     }
@@ -1040,6 +1057,11 @@ class Consume : public NonTransferable {
       return c->moveTowards(target->getPosition());
   }
 
+  REGISTER_HANDLER(DiscardCreatureEvent, const Creature* c) {
+    if (target == c)
+      target = nullptr;
+  }
+
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version) {
     ar& SUBCLASS(NonTransferable)
@@ -9,9 +9,17 @@ void TaskMap<CostInfo>::serialize(Archive& ar, const unsigned int version) {
   ar& SVAR(tasks)
     & SVAR(positionMap)
     & SVAR(creatureMap)
-    & SVAR(marked)
-    & SVAR(lockedTasks)
-    & SVAR(completionCost)
+    & SVAR(marked);
+  if (version == 0) {
+    set<pair<const Creature*, UniqueEntity<Task>::Id>> lockedSet;
+    ar & BOOST_SERIALIZATION_NVP(lockedSet);
+    // Locks from old saves have no time, so they are expired straight away.
+    for (auto& elem : lockedSet)
+      lockedTasks[elem] = -lockTimeout;
+    SKIP_SERIAL(lockedTasks);
+  } else
+    ar & SVAR(lockedTasks);
+  ar& SVAR(completionCost)
     & SVAR(priorityTasks)
     & SVAR(delayedTasks);
   CHECK_SERIAL;
@@ -30,19 +38,30 @@ Task* TaskMap<CostInfo>::getTaskForWorker(Creature* c) {
       if ((!owner || (task->canTransfer() && (*pos - owner->getPosition()).length8() > dist))
           && (!closest || dist < (*getPosition(closest) - c->getPosition()).length8()
               || priorityTasks.contains(task.get()))
-          && !isLocked(c, task.get())
+          && !isLocked(c, task.get(), c->getTime())
           && (!delayedTasks.count(task->getUniqueId()) || delayedTasks.at(task->getUniqueId()) < c->getTime())) {
         bool valid = task->getMove(c);
         if (valid)
           closest = task.get();
         else
-          lock(c, task.get());
+          lock(c, task.get(), c->getTime());
       }
     }
   }
   return closest;
 }
 
+template <class CostInfo>
+map<Vec2, vector<Task*>> TaskMap<CostInfo>::getFreeTasks(double time, bool priorityOnly) const {
+  map<Vec2, vector<Task*>> ret;
+  for (const PTask& task : tasks)
+    if (auto pos = getPosition(task.get()))
+      if (!getOwner(task.get()) && (!priorityOnly || priorityTasks.contains(task.get()))
+          && (!delayedTasks.count(task->getUniqueId()) || delayedTasks.at(task->getUniqueId()) < time))
+        ret[*pos].push_back(task.get());
+  return ret;
+}
+
 template <class CostInfo>
 void TaskMap<CostInfo>::freeTaskDelay(Task* t, double d) {
   freeTask(t);
@@ -69,8 +88,10 @@ CostInfo TaskMap<CostInfo>::removeTask(Task* task) {
     completionCost.erase(task);
   }
   if (auto pos = getPosition(task))
-    if (marked.count(*pos))
+    if (marked.count(*pos)) {
       marked.erase(*pos);
+      ++markedVersion;
+    }
   for (int i : All(tasks))
     if (tasks[i].get() == task) {
       removeIndex(tasks, i);
@@ -93,13 +114,23 @@ CostInfo TaskMap<CostInfo>::removeTask(UniqueEntity<Task>::Id id) {
 }
 
 template <class CostInfo>
-bool TaskMap<CostInfo>::isLocked(const Creature* c, const Task* t) const {
-  return lockedTasks.count({c, t->getUniqueId()});
+bool TaskMap<CostInfo>::isLocked(const Creature* c, const Task* t, double time) const {
+  auto it = lockedTasks.find({c, t->getUniqueId()});
+  return it != lockedTasks.end() && time < it->second + lockTimeout;
 }
 
 template <class CostInfo>
-void TaskMap<CostInfo>::lock(const Creature* c, const Task* t) {
-  lockedTasks.insert({c, t->getUniqueId()});
+void TaskMap<CostInfo>::lock(const Creature* c, const Task* t, double time) {
+  lockedTasks[{c, t->getUniqueId()}] = time;
+}
+
+template <class CostInfo>
+void TaskMap<CostInfo>::unlock(const Creature* c) {
+  for (auto it = lockedTasks.begin(); it != lockedTasks.end();)
+    if (it->first.first == c)
+      it = lockedTasks.erase(it);
+    else
+      ++it;
 }
 
 template <class CostInfo>
@@ -107,6 +138,23 @@ void TaskMap<CostInfo>::clearAllLocked() {
   lockedTasks.clear();
 }
 
+template <class CostInfo>
+void TaskMap<CostInfo>::clearLocked(function<bool(const Creature*, Vec2)> pred) {
+  map<UniqueEntity<Task>::Id, Task*> byId;
+  for (PTask& task : tasks)
+    byId[task->getUniqueId()] = task.get();
+  for (auto it = lockedTasks.begin(); it != lockedTasks.end();) {
+    bool release = !byId.count(it->first.second);
+    if (!release)
+      if (auto pos = getPosition(byId.at(it->first.second)))
+        release = pred(it->first.first, *pos);
+    if (release)
+      it = lockedTasks.erase(it);
+    else
+      ++it;
+  }
+}
+
 template <class CostInfo>
 Task* TaskMap<CostInfo>::getMarked(Vec2 pos) const {
   if (marked.count(pos))
@@ -115,9 +163,15 @@ Task* TaskMap<CostInfo>::getMarked(Vec2 pos) const {
     return nullptr;
 }
 
+template <class CostInfo>
+int TaskMap<CostInfo>::getMarkedVersion() const {
+  return markedVersion;
+}
+
 template <class CostInfo>
 void TaskMap<CostInfo>::markSquare(Vec2 pos, PTask task) {
   marked[pos] = task.get();
+  ++markedVersion;
   addTask(std::move(task), pos);
 }
 
@@ -125,6 +179,7 @@ template <class CostInfo>
 void TaskMap<CostInfo>::unmarkSquare(Vec2 pos) {
   Task* task = marked.at(pos);
   marked.erase(pos);
+  ++markedVersion;
   removeTask(task);
 }
 
@@ -136,6 +191,14 @@ Task* TaskMap<CostInfo>::getTask(const Creature* c) const {
     return nullptr;
 }
 
+template <class CostInfo>
+Task* TaskMap<CostInfo>::getTask(UniqueEntity<Task>::Id id) const {
+  for (const PTask& task : tasks)
+    if (task->getUniqueId() == id)
+      return task.get();
+  return nullptr;
+}
+
 template <class CostInfo>
 vector<Task*> TaskMap<CostInfo>::getTasks(Vec2 pos) const {
   vector<Task*> ret;
@@ -13,6 +13,7 @@ class TaskMap {
   Task* addTask(PTask, const Creature*);
   Task* addTask(PTask, Vec2);
   Task* getTask(const Creature*) const;
+  Task* getTask(UniqueEntity<Task>::Id) const;
   vector<Task*> getTasks(Vec2) const;
   const Creature* getOwner(Task*) const;
   Optional<Vec2> getPosition(Task*) const;
@@ -24,14 +25,22 @@ class TaskMap {
   void markSquare(Vec2 pos, PTask);
   void unmarkSquare(Vec2 pos);
   Task* getMarked(Vec2 pos) const;
+  /** Changes whenever a square is marked or unmarked.*/
+  int getMarkedVersion() const;
   CostInfo removeTask(Task*);
   CostInfo removeTask(UniqueEntity<Task>::Id);
-  bool isLocked(const Creature*, const Task*) const;
-  void lock(const Creature*, const Task*);
+  /** Checks if the creature failed to reach the task recently. Locks expire after lockTimeout turns.*/
+  bool isLocked(const Creature*, const Task*, double time) const;
+  void lock(const Creature*, const Task*, double time);
+  /** Drops all locks of the creature.*/
+  void unlock(const Creature*);
   void clearAllLocked();
+  /** Releases the locks for which the predicate holds. Locks of removed tasks are dropped as well.*/
+  void clearLocked(function<bool(const Creature*, Vec2 taskPos)>);
   void freeTaskDelay(Task*, double delayTime);
   void setPriorityTasks(Vec2 pos);
   Task* getTaskForWorker(Creature* c);
+  map<Vec2, vector<Task*>> getFreeTasks(double time, bool priorityOnly = false) const;
   const map<Task*, CostInfo>& getCompletionCosts() const;
 
   template <class Archive>
@@ -44,8 +53,11 @@ class TaskMap {
   map<Task*, Vec2> SERIAL(positionMap);
   vector<PTask> SERIAL(tasks);
   map<Vec2, Task*> SERIAL(marked);
+  int markedVersion = 0;
   map<Task*, CostInfo> SERIAL(completionCost);
-  set<pair<const Creature*, UniqueEntity<Creature>::Id>> SERIAL(lockedTasks);
+  /** A failed task is retried after this many turns, even if no sector change released its lock.*/
+  const static int lockTimeout = 100;
+  map<pair<const Creature*, UniqueEntity<Task>::Id>, double> SERIAL(lockedTasks);
   map<UniqueEntity<Creature>::Id, double> SERIAL(delayedTasks);
   EntitySet<Task> SERIAL(priorityTasks);
 };
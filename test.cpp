@@ -21,6 +21,32 @@
 #include "level_maker.h"
 #include "test.h"
 #include "sectors.h"
+#include "timer_wheel.h"
+#include "triple_buffer.h"
+#include "map_memory.h"
+#include "view_object.h"
+#include "view_id.h"
+#include "compressed_stream.h"
+#include "save_header.h"
+#include "collective.h"
+#include "task_map.h"
+#include "task.h"
+#include "window_view.h"
+#include "model.h"
+#include "level.h"
+#include "square.h"
+#include "creature.h"
+#include "creature_view.h"
+#include "script_context.h"
+#include "tile.h"
+#include "creature_factory.h"
+#include "monster_ai.h"
+#include "tribe.h"
+#include "skill.h"
+#include "vision.h"
+#include "name_generator.h"
+#include "item_factory.h"
+#include "serialization.h"
 
 void testStringConvertion() {
   CHECK(convertToString(1234) == "1234");
@@ -51,6 +77,55 @@ void testTimeQueue() {
   CHECK(q.getNextCreature() == ra);*/
 }
 
+void testTimerWheel() {
+  TimerWheel<int> wheel;
+  wheel.add(1, 0.5);
+  wheel.add(2, 3);
+  wheel.add(3, 70);
+  wheel.add(4, 10000);
+  CHECK(wheel.popDue(0).empty());
+  CHECK(wheel.popDue(1) == vector<int>({1}));
+  CHECK(wheel.popDue(2).empty());
+  CHECK(wheel.popDue(69) == vector<int>({2}));
+  wheel.add(5, 50);
+  CHECK(wheel.popDue(70) == vector<int>({3, 5}));
+  CHECK(wheel.getSize() == 1);
+  CHECK(wheel.popDue(9999).empty());
+  CHECK(wheel.popDue(10000) == vector<int>({4}));
+  CHECK(wheel.getSize() == 0);
+}
+
+void testTripleBuffer() {
+  TripleBuffer<int> buffer;
+  CHECK(!buffer.update());
+  buffer.getWriteBuffer() = 1;
+  buffer.publish();
+  buffer.getWriteBuffer() = 2;
+  buffer.publish();
+  CHECK(buffer.update());
+  CHECKEQ(buffer.getReadBuffer(), 2);
+  CHECK(!buffer.update());
+  buffer.getWriteBuffer() = 3;
+  CHECK(!buffer.update());
+  buffer.publish();
+  CHECK(buffer.update());
+  CHECKEQ(buffer.getReadBuffer(), 3);
+  TripleBuffer<int> shared;
+  std::thread producer([&] {
+    for (int i : Range(1, 10001)) {
+      shared.getWriteBuffer() = i;
+      shared.publish();
+    }
+  });
+  int last = 0;
+  while (last < 10000)
+    if (shared.update()) {
+      CHECK(shared.getReadBuffer() > last);
+      last = shared.getReadBuffer();
+    }
+  producer.join();
+}
+
 void testRectangleIterator() {
   vector<Vec2> v1, v2;
   for (Vec2 v : Rectangle(10, 10)) {
@@ -137,6 +212,17 @@ void testShortestPathReverse() {
   CHECK(res == expected);*/
 }
 
+void testDijkstraMultiSource() {
+  vector<vector<double> > table { { 1, 1, 1, 1, 1, 1, 1}, { 1, 1, 1, ShortestPath::infinity, 1, 1, 1}, { 1, 1, 1, ShortestPath::infinity, 1, 1, 1}};
+  Dijkstra dijkstra(Rectangle(7, 3), {Vec2(0, 2), Vec2(6, 2)}, 10,
+      [table](Vec2 pos) { return table[pos.y][pos.x];}, Vec2::directions4());
+  CHECK(dijkstra.getSource(Vec2(1, 1)) == Vec2(0, 2));
+  CHECK(dijkstra.getSource(Vec2(5, 0)) == Vec2(6, 2));
+  CHECK(dijkstra.getDist(Vec2(2, 2)) == 2);
+  CHECK(dijkstra.getDist(Vec2(4, 2)) == 2);
+  CHECK(!dijkstra.isReachable(Vec2(3, 2)));
+}
+
 void testRandom() {
   CHECK(chooseRandom<string>({"pokpok", "kwakwa", "pikpik"}, { 1, 2, 3}, 1) == "pokpok");
   CHECK(chooseRandom<string>({"pokpok", "kwakwa", "pikpik"}, { 1, 2, 3}, 2) == "kwakwa");
@@ -196,6 +282,9 @@ void testOptional() {
   CHECK(r);
   CHECK(r == 1);
   CHECK(!getInt(false));
+  CHECK(r == getInt(true));
+  CHECK(!(r == getInt(false)));
+  CHECK(getInt(false) == getInt(false));
 }
 
 void testMustInitialize() {
@@ -270,6 +359,117 @@ void testTable() {
   CHECK(t2[39][49] == 39 * 49);
 }
 
+void testTableSerialization() {
+  Table<double> t1(Rectangle(-3, 2, 40, 30));
+  Table<string> t2(5, 6, "a");
+  for (Vec2 v : t1.getBounds())
+    t1[v] = v.x * 0.5 + v.y;
+  t2[2][3] = "b";
+  std::stringstream ss;
+  {
+    binary_oarchive ar(ss);
+    ar << BOOST_SERIALIZATION_NVP(t1) << BOOST_SERIALIZATION_NVP(t2);
+  }
+  Table<double> t3(1, 1);
+  Table<string> t4(1, 1);
+  {
+    binary_iarchive ar(ss);
+    ar >> BOOST_SERIALIZATION_NVP(t3) >> BOOST_SERIALIZATION_NVP(t4);
+  }
+  CHECK(t3.getBounds() == t1.getBounds());
+  for (Vec2 v : t1.getBounds())
+    CHECK(t3[v] == t1[v]);
+  CHECKEQ(t4[2][3], string("b"));
+  CHECKEQ(t4[4][5], string("a"));
+  vector<string> saved;
+  for (int i : Range(2)) {
+    Table<Level::CoverInfo> covers(7, 3);
+    for (Vec2 v : covers.getBounds())
+      covers[v] = {v.x % 2 == 0, v.y * 0.25};
+    std::ostringstream out;
+    {
+      binary_oarchive ar(out);
+      ar << BOOST_SERIALIZATION_NVP(covers);
+    }
+    saved.push_back(out.str());
+  }
+  CHECK(saved[0] == saved[1]);
+  std::istringstream in(saved[0]);
+  Table<Level::CoverInfo> covers(1, 1);
+  {
+    binary_iarchive ar(in);
+    ar >> BOOST_SERIALIZATION_NVP(covers);
+  }
+  CHECK(!covers[1][2].covered && covers[2][2].covered && covers[6][2].sunlight == 0.5);
+}
+
+void testRandomStream() {
+  Random.init(5);
+  int seed = Random.getSeed();
+  vector<int> drawn;
+  {
+    RandomStream stream(seed);
+    for (int i : Range(10))
+      drawn.push_back(Random.getRandom(1000));
+  }
+  int next = Random.getRandom(1000);
+  vector<int> drawnInThread;
+  thread([&] {
+      RandomStream stream(seed);
+      for (int i : Range(10))
+        drawnInThread.push_back(Random.getRandom(1000));
+  }).join();
+  CHECK(drawn == drawnInThread);
+  Random.init(5);
+  Random.getSeed();
+  CHECKEQ(Random.getRandom(1000), next);
+}
+
+void testRunInParallel() {
+  vector<int> results(20);
+  vector<function<void()>> tasks;
+  for (int i : All(results))
+    tasks.push_back([&results, i] { results[i] = i + Random.getRandom(1000);});
+  Random.init(7);
+  runInParallel(tasks);
+  Random.init(7);
+  vector<int> seeds;
+  for (int i : All(results))
+    seeds.push_back(Random.getSeed());
+  for (int i : All(results)) {
+    RandomStream stream(seeds[i]);
+    CHECKEQ(results[i], i + Random.getRandom(1000));
+  }
+  bool thrown = false;
+  try {
+    runInParallel({[] {}, [] { throw string("task failed"); }});
+  } catch (string s) {
+    thrown = true;
+    CHECKEQ(s, string("task failed"));
+  }
+  CHECK(thrown);
+}
+
+void testRandomGenSerialization() {
+  RandomGen r1;
+  r1.init(123);
+  r1.getRandom("shuffle", 0, 10);
+  std::stringstream ss;
+  {
+    binary_oarchive ar(ss);
+    ar << BOOST_SERIALIZATION_NVP(r1);
+  }
+  RandomGen r2;
+  {
+    binary_iarchive ar(ss);
+    ar >> BOOST_SERIALIZATION_NVP(r2);
+  }
+  for (int i : Range(100))
+    CHECKEQ(r1.getRandom(1000), r2.getRandom(1000));
+  for (int i : Range(9))
+    CHECKEQ(r1.getRandom("shuffle", 0, 10), r2.getRandom("shuffle", 0, 10));
+}
+
 void testProjection() {
 /*  Vec2 proj = AllegroView::projectOnBorders(Rectangle(5, 5), Vec2(6, 0));
   CHECKEQ(proj, Vec2(4, 1));
@@ -386,6 +586,132 @@ void testSectors2() {
   CHECK(!s.same(Vec2(0, 3), Vec2(3, 2)));
 }
 
+void testSectorsNeighbors() {
+  Sectors s(Rectangle(5, 3));
+  s.add(Vec2(0, 1));
+  s.add(Vec2(4, 1));
+  CHECK(s.getNeighbors(Vec2(2, 1)).empty());
+  s.add(Vec2(1, 1));
+  set<int> joined = s.getNeighbors(Vec2(2, 1));
+  CHECK(joined.size() == 1);
+  s.add(Vec2(3, 1));
+  joined = s.getNeighbors(Vec2(2, 1));
+  CHECK(joined.size() == 2);
+  CHECK(s.contains(Vec2(0, 1), joined) && s.contains(Vec2(4, 1), joined));
+  s.add(Vec2(2, 1));
+  CHECK(s.getNeighbors(Vec2(2, 0)).size() == 1);
+  CHECK(s.same(Vec2(0, 1), Vec2(4, 1)));
+}
+
+void testSectorsConnecting() {
+  Sectors s(Rectangle(7, 3));
+  s.add(Vec2(0, 1));
+  s.add(Vec2(1, 1));
+  s.add(Vec2(3, 1));
+  s.add(Vec2(4, 1));
+  s.add(Vec2(6, 1));
+  CHECK(s.isConnecting(Vec2(2, 1), Vec2(0, 1), Vec2(4, 0)));
+  CHECK(!s.isConnecting(Vec2(2, 1), Vec2(0, 1), Vec2(6, 0)));
+  CHECK(!s.isConnecting(Vec2(5, 1), Vec2(0, 1), Vec2(6, 0)));
+  CHECK(!s.isConnecting(Vec2(2, 1), Vec2(6, 1), Vec2(4, 1)));
+  s.add(Vec2(2, 1));
+  CHECK(!s.isConnecting(Vec2(2, 0), Vec2(0, 1), Vec2(4, 1)));
+}
+
+class FloorLevelMaker : public LevelMaker {
+  public:
+  virtual void make(Level::Builder* builder, Rectangle area) override {
+    for (Vec2 v : area)
+      builder->putSquare(v, SquareId::FLOOR);
+  }
+};
+
+/** A 10x10 floor level in a fresh model. The game data is initialized by the first fixture.*/
+class TestLevel {
+  public:
+  TestLevel(View* view = nullptr) : model(view), level(Level::Builder(10, 10, "test").build(&model, &maker)) {}
+
+  private:
+  struct GameData {
+    GameData() {
+      static bool initialized = false;
+      if (!initialized) {
+        Tribe::init();
+        Skill::init();
+        Vision::init();
+        NameGenerator::init();
+        ItemFactory::init();
+        initialized = true;
+      }
+    }
+  } gameData;
+
+  public:
+  Model model;
+  FloorLevelMaker maker;
+  PLevel level;
+};
+
+void testTaskMapLocks() {
+  TestLevel test;
+  Tribe* tribe = Tribe::get(TribeId::MONSTER);
+  PCreature c1 = CreatureFactory::fromId(CreatureId::GOBLIN, tribe, MonsterAIFactory::idle());
+  PCreature c2 = CreatureFactory::fromId(CreatureId::GOBLIN, tribe, MonsterAIFactory::idle());
+  TaskMap<Collective::CostInfo> taskMap;
+  Task* near = taskMap.addTask(Task::explore(Vec2(3, 3)), Vec2(3, 3));
+  Task* far = taskMap.addTask(Task::explore(Vec2(20, 3)), Vec2(20, 3));
+  taskMap.lock(c1.get(), near, 10);
+  taskMap.lock(c2.get(), near, 10);
+  taskMap.lock(c1.get(), far, 10);
+  CHECK(taskMap.isLocked(c1.get(), near, 10) && !taskMap.isLocked(c2.get(), far, 10));
+  taskMap.clearLocked([&](const Creature* c, Vec2 pos) { return c == c2.get() && pos.dist8(Vec2(4, 4)) <= 1; });
+  CHECK(taskMap.isLocked(c1.get(), near, 20) && !taskMap.isLocked(c2.get(), near, 20)
+      && taskMap.isLocked(c1.get(), far, 20));
+  taskMap.lock(c2.get(), near, 1000);
+  CHECK(!taskMap.isLocked(c1.get(), near, 1000) && taskMap.isLocked(c2.get(), near, 1000));
+  taskMap.unlock(c2.get());
+  CHECK(!taskMap.isLocked(c2.get(), near, 1000));
+}
+
+void testTaskMapMarkedVersion() {
+  TaskMap<Collective::CostInfo> taskMap;
+  int version = taskMap.getMarkedVersion();
+  taskMap.markSquare(Vec2(3, 3), Task::explore(Vec2(3, 3)));
+  CHECK(taskMap.getMarkedVersion() != version);
+  version = taskMap.getMarkedVersion();
+  taskMap.removeTask(taskMap.getMarked(Vec2(3, 3)));
+  CHECK(taskMap.getMarkedVersion() != version && !taskMap.getMarked(Vec2(3, 3)));
+  version = taskMap.getMarkedVersion();
+  taskMap.addTask(Task::explore(Vec2(5, 5)), Vec2(5, 5));
+  CHECK(taskMap.getMarkedVersion() == version);
+}
+
+void testMapMemory() {
+  MapMemory memory;
+  Vec2 pos(100, 37);
+  CHECK(!memory.hasViewIndex(pos) && !memory.hasViewIndex(Vec2(101, 37)));
+  ViewIndex index;
+  ViewObject floor(ViewId::FLOOR, ViewLayer::FLOOR, "Floor");
+  floor.setAttribute(ViewObject::Attribute::BURNING, 0.5).setAttribute(ViewObject::Attribute::EFFICIENCY, 0.25);
+  index.insert(floor);
+  index.insert(ViewObject(ViewId::PLAYER, ViewLayer::CREATURE, "Player"));
+  index.insert(ViewObject(ViewId::FLOOR, ViewLayer::TORCH1, "Torch").setAttachmentDir(Dir::N)
+      .setModifier(ViewObject::Modifier::CASTS_SHADOW));
+  memory.update(pos, index, 5);
+  CHECK(memory.hasViewIndex(pos) && !memory.hasViewIndex(Vec2(101, 37)));
+  CHECK(memory.isUpToDate(pos, 5) && !memory.isUpToDate(pos, 6));
+  MapMemory copy(memory);
+  ViewIndex remembered = copy.getViewIndex(pos);
+  CHECK(!remembered.hasObject(ViewLayer::CREATURE));
+  CHECK(remembered.getObject(ViewLayer::FLOOR) == floor);
+  CHECKEQ(remembered.getObject(ViewLayer::FLOOR).getAttribute(ViewObject::Attribute::BURNING), 0.5);
+  CHECK(remembered.getObject(ViewLayer::TORCH1).getAttachmentDir() == Dir::N);
+  CHECK(remembered.getObject(ViewLayer::TORCH1).hasModifier(ViewObject::Modifier::CASTS_SHADOW));
+  CHECK(remembered.getHighlight(HighlightType::MEMORY) > 0);
+  memory.clearSquare(pos);
+  CHECK(!memory.hasViewIndex(pos) && copy.hasViewIndex(pos));
+}
+
 void testReverse() {
   vector<int> v1 {1, 2, 3, 4};
   vector<int> v2 {4, 3, 2, 1};
@@ -404,10 +730,210 @@ void testReverse3() {
   CHECKEQ(reverse2(v1), v2);
 }
 
+void testCompressedStream() {
+  const string path = "compressed_test.tmp";
+  string content;
+  for (int i : Range(200000))
+    content += convertToString(i % 1000) + " ";
+  {
+    CompressedOutputStream output(path);
+    CHECK(output.good());
+    output << content;
+  }
+  {
+    CompressedInputStream input(path);
+    CHECK(input.good());
+    string read((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    CHECK(read == content);
+  }
+  {
+    // Stop reading early, the decompressor has to be stopped cleanly.
+    CompressedInputStream input(path);
+    string word;
+    input >> word;
+    CHECKEQ(word, string("0"));
+  }
+  {
+    // Old saves were written without compression.
+    ofstream output(path);
+    output << content;
+  }
+  {
+    CompressedInputStream input(path);
+    string read((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    CHECK(read == content);
+  }
+  remove(path.c_str());
+  CompressedInputStream missing("nonexistent_file.tmp");
+  CHECK(!missing.good());
+}
+
+void testSaveHeader() {
+  const string path = "header_test.tmp";
+  const string indexPath = "header_test_index.tmp";
+  SaveHeader header;
+  header.gameType = GameType::RETIRED_KEEPER;
+  header.identifier = "Keeper name";
+  header.gameTime = 1234;
+  header.numCreatures = 56;
+  {
+    CompressedOutputStream output(path, CompressedOutputStream::defaultLevel, SaveHeader::size);
+    output << "model data";
+    header.checksum = output.close();
+  }
+  header.write(path);
+  CHECK(SaveHeader::read(path) == header);
+  {
+    CompressedInputStream input(path, SaveHeader::size);
+    string read((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    CHECKEQ(read, string("model data"));
+    CHECK(input.close() == header.checksum);
+  }
+  {
+    SaveIndex index(indexPath);
+    CHECK(index.getHeader(path, 100, 200) == header);
+    index.save();
+  }
+  SaveHeader other = header;
+  other.gameTime = 5;
+  other.write(path);
+  {
+    SaveIndex index(indexPath);
+    CHECK(index.getHeader(path, 100, 200) == header);
+    CHECK(index.getHeader(path, 101, 200) == other);
+  }
+  {
+    ofstream(path) << "old save";
+  }
+  CHECK(!SaveHeader::read(path));
+  remove(path.c_str());
+  remove(indexPath.c_str());
+}
+
+struct ProfiledStruct {
+  SERIAL_CHECKER;
+  vector<int> SERIAL(big);
+  int SERIAL(small);
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int) {
+    ar & SVAR(big) & SVAR(small);
+    CHECK_SERIAL;
+  }
+};
+
+struct PlainStruct {
+  vector<int> big;
+  int small;
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int) {
+    ar & BOOST_SERIALIZATION_NVP(big) & BOOST_SERIALIZATION_NVP(small);
+  }
+};
+
+void testSerialProfiler() {
+  ProfiledStruct profiled;
+  profiled.big = vector<int>(1000, 5);
+  profiled.small = 3;
+  PlainStruct plain {profiled.big, profiled.small};
+  std::stringstream ss1, ss2;
+  {
+    binary_oarchive ar1(ss1);
+    binary_oarchive ar2(ss2);
+    ar1 << profiled;
+    ar2 << plain;
+  }
+  // The profiling wrapper doesn't change the format.
+  CHECKEQ(ss1.str(), ss2.str());
+  std::stringstream report;
+  {
+    SerialProfiler profiler;
+    {
+      binary_oarchive ar(profiler.getStream());
+      ar << profiled;
+    }
+    profiler.printReport(report);
+  }
+  vector<string> lines;
+  string line;
+  while (getline(report, line))
+    lines.push_back(line);
+  CHECKEQ((int) lines.size(), 4);
+  CHECK(contains(lines[0], "Total " + convertToString(ss1.str().size()) + " bytes")) << lines[0];
+  CHECK(contains(lines[2], string("ProfiledStruct::big "))) << lines[2];
+  CHECK(contains(lines[3], string("ProfiledStruct::small "))) << lines[3];
+  CHECK(!SerialProfiler::isActive());
+}
+
+class SeeAllView : public CreatureView {
+  public:
+  SeeAllView(const Level* l) : level(l) {}
+  virtual const MapMemory& getMemory() const override { return memory; }
+  virtual void getViewIndex(Vec2 pos, ViewIndex& index) const override {
+    level->getSquare(pos)->getViewIndex(this, index);
+  }
+  virtual void refreshGameInfo(GameInfo&) const override {}
+  virtual Vec2 getPosition() const override { return level->getBounds().middle(); }
+  virtual bool canSee(const Creature*) const override { return true; }
+  virtual bool canSee(Vec2) const override { return true; }
+  virtual const Level* getViewLevel() const override { return level; }
+  virtual vector<const Creature*> getUnknownAttacker() const override { return {}; }
+  virtual const Tribe* getTribe() const override { return nullptr; }
+  virtual bool isEnemy(const Creature*) const override { return false; }
+  virtual int getMaxSightRange() const override { return 100; }
+
+  private:
+  const Level* level;
+  MapMemory memory;
+};
+
+void testTombstone() {
+  TestLevel test;
+  Tribe* tribe = Tribe::get(TribeId::MONSTER);
+  PCreature c = CreatureFactory::fromId(CreatureId::ORC, tribe, MonsterAIFactory::idle());
+  Creature* attacker = c.get();
+  test.level->addCreature(Vec2(2, 2), std::move(c));
+  c = CreatureFactory::addInventory(CreatureFactory::fromId(CreatureId::GOBLIN, tribe, MonsterAIFactory::idle()),
+      {ItemId::SWORD, ItemId::LEATHER_ARMOR});
+  Creature* victim = c.get();
+  UniqueEntity<Creature>::Id victimId = victim->getUniqueId();
+  ViewId viewId = victim->getViewObject().id();
+  string name = victim->getName();
+  test.level->addCreature(Vec2(3, 3), std::move(c));
+  victim->die(attacker, false);
+  CHECK(test.model.getCreature(victimId) == victim);
+  CHECK(!test.model.getTombstone(victimId));
+  test.model.tick(1);
+  CHECK(!test.model.getCreature(victimId));
+  CHECK(!contains(tribe->getMembers(true), (const Creature*) victim));
+  const Model::Tombstone* tombstone = test.model.getTombstone(victimId);
+  CHECK(tombstone);
+  CHECKEQ(tombstone->name, name);
+  CHECK(tombstone->viewId == viewId);
+  CHECK(tombstone->tribe == tribe);
+  CHECK(tombstone->killer == attacker->getUniqueId());
+  CHECK(attacker->getKills() == vector<UniqueEntity<Creature>::Id>({victimId}));
+}
+
+void testRenderBenchmark() {
+  ScriptContext::init();
+  Tile::initialize();
+  WindowView view;
+  view.initializeHeadless(400, 300);
+  TestLevel test(&view);
+  SeeAllView seeAll(test.level.get());
+  WindowView::RenderStats stats = view.benchmarkRendering(&seeAll, 2);
+  CHECKEQ(stats.frames, 2);
+  CHECK(stats.commandsPerFrame > 0);
+}
+
 int testAll() {
   Debug::init();
   testStringConvertion();
   testTimeQueue();
+  testTimerWheel();
+  testTripleBuffer();
   testRectangleIterator();
   testValueCheck();
   testSplit();
@@ -415,6 +941,7 @@ int testAll() {
   testAStar();
   testShortestPath2();
   testShortestPathReverse();
+  testDijkstraMultiSource();
   testRandom();
   testRange();
   testContains();
@@ -424,6 +951,7 @@ int testAll() {
   testVec2();
   testConcat();
   testTable();
+  testTableSerialization();
   testVec2();
   testRectangle();
   testProjection();
@@ -434,9 +962,28 @@ int testAll() {
   testVec2Box2();
   testSectors1();
   testSectors2();
+  testSectorsNeighbors();
+  testSectorsConnecting();
+  testTaskMapLocks();
+  testTaskMapMarkedVersion();
+  testMapMemory();
   testReverse();
   testReverse2();
   testReverse3();
+  testCompressedStream();
+  testSaveHeader();
+  testSerialProfiler();
+  testRandomGenSerialization();
+  testRandomStream();
+  testRunInParallel();
+  testTombstone();
+  Debug() << "-----===== OK =====-----";
+  return 0;
+}
+
+int testRender() {
+  Debug::init();
+  testRenderBenchmark();
   Debug() << "-----===== OK =====-----";
   return 0;
 }
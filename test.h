@@ -17,5 +17,7 @@
 #define _TEST_H
 
 int testAll();
+/** Tests that load textures and fonts, so they need a display.*/
+int testRender();
 
 #endif
@@ -21,8 +21,18 @@
 template <class Archive> 
 void TimeQueue::serialize(Archive& ar, const unsigned int version) { 
   ar& SVAR(creatures)
-    & SVAR(queue)
-    & SVAR(dead);
+    & SVAR(queue);
+  if (version == 0) {
+    // Old saves left removed creatures in the queue.
+    unordered_set<Creature*> dead;
+    ar & BOOST_SERIALIZATION_NVP(dead);
+    vector<QElem> rest;
+    for (; !queue.empty(); queue.pop())
+      if (!dead.count(queue.top().creature))
+        rest.push_back(queue.top());
+    for (QElem& elem : rest)
+      queue.push(elem);
+  }
   CHECK_SERIAL;
 }
 
@@ -57,7 +67,13 @@ PCreature TimeQueue::removeCreature(Creature* cRef) {
   CHECK(ind > -1) << "Creature not found";
   PCreature ret = std::move(creatures[ind]);
   creatures.erase(creatures.begin() + ind);
-  dead.insert(ret.get());
+  // The creature will be destroyed, so it can't stay in the queue.
+  vector<QElem> rest;
+  for (; !queue.empty(); queue.pop())
+    if (queue.top().creature != cRef)
+      rest.push_back(queue.top());
+  for (QElem& elem : rest)
+    queue.push(elem);
   return ret;
 }
 
@@ -68,20 +84,13 @@ vector<Creature*> TimeQueue::getAllCreatures() const {
   return ret;
 }
 
-void TimeQueue::removeDead() {
-  while (!queue.empty() && dead.count(queue.top().creature))
-    queue.pop();
-}
-
 Creature* TimeQueue::getMinCreature() {
   CHECK(creatures.size() > 0);
-  removeDead();
   QElem elem = queue.top();
   if (elem.time == elem.creature->getTime())
     return elem.creature;
   else {
     queue.pop();
-    removeDead();
     queue.push({elem.creature, elem.creature->getTime()});
     CHECK(queue.top().creature->getTime() == queue.top().time);
     return queue.top().creature;
@@ -35,7 +35,6 @@ class TimeQueue {
   SERIAL_CHECKER;
 
   private:
-  void removeDead();
   Creature* getMinCreature();
 
   vector<PCreature> SERIAL(creatures);
@@ -48,7 +47,9 @@ class TimeQueue {
     void serialize(Archive& ar, const unsigned int version);
   };
   priority_queue<QElem, vector<QElem>, function<bool(QElem, QElem)>> SERIAL(queue);
-  unordered_set<Creature*> SERIAL(dead);
 };
 
+// Version 1 removes creatures from the queue right away.
+BOOST_CLASS_VERSION(TimeQueue, 1)
+
 #endif
@@ -0,0 +1,81 @@
+/* Copyright (C) 2013-2014 Michal Brzozowski (rusolis@poczta.fm)
+
+   This file is part of KeeperRL.
+
+   KeeperRL is free software; you can redistribute it and/or modify it under the terms of the
+   GNU General Public License as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   KeeperRL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+   even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with this program.
+   If not, see http://www.gnu.org/licenses/ . */
+
+#ifndef _TIMER_WHEEL_H
+#define _TIMER_WHEEL_H
+
+#include "util.h"
+
+/** Schedules elements by game turn. The current block of turns has a slot per turn, the next blocks
+ have a slot per block and are moved down when their block starts. Anything further waits in an ordered map.*/
+template <class T>
+class TimerWheel {
+  public:
+  void add(const T& elem, double time) {
+    int turn = max(current, (int) ceil(time));
+    int block = turn / numSlots;
+    if (block == current / numSlots)
+      near[turn % numSlots].push_back(elem);
+    else if (block < current / numSlots + numSlots)
+      far[block % numSlots].push_back({turn, elem});
+    else
+      overflow[turn].push_back(elem);
+    ++count;
+  }
+
+  /** Removes and returns all elements scheduled up to the given time.*/
+  vector<T> popDue(double time) {
+    int until = floor(time);
+    vector<T> ret;
+    while (current <= until && count > 0) {
+      vector<T>& slot = near[current % numSlots];
+      count -= slot.size();
+      append(ret, slot);
+      slot.clear();
+      if (++current % numSlots == 0)
+        cascade();
+    }
+    if (count == 0)
+      current = max(current, until + 1);
+    return ret;
+  }
+
+  int getSize() const {
+    return count;
+  }
+
+  private:
+  void cascade() {
+    int block = current / numSlots;
+    for (auto& elem : far[block % numSlots])
+      near[elem.first % numSlots].push_back(elem.second);
+    far[block % numSlots].clear();
+    while (!overflow.empty() && overflow.begin()->first / numSlots < block + numSlots) {
+      int turn = overflow.begin()->first;
+      for (auto& elem : overflow.begin()->second)
+        far[(turn / numSlots) % numSlots].push_back({turn, elem});
+      overflow.erase(overflow.begin());
+    }
+  }
+
+  const static int numSlots = 64;
+  int current = 0;
+  int count = 0;
+  vector<vector<T>> near = vector<vector<T>>(numSlots);
+  vector<vector<pair<int, T>>> far = vector<vector<pair<int, T>>>(numSlots);
+  map<int, vector<T>> overflow;
+};
+
+#endif
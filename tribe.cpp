@@ -143,6 +143,12 @@ void Tribe::onAttackEvent(Creature* member, Creature* attacker) {
   standing[attacker] -= attackPenalty * getMultiplier(member);
 }
 
+void Tribe::onDiscardCreatureEvent(const Creature* c) {
+  standing.erase(c);
+  attacks = filter(attacks, [c](const pair<Creature*, Creature*>& attack) {
+      return attack.first != c && attack.second != c; });
+}
+
 void Tribe::addMember(const Creature* c) {
   members.push_back(c);
 }
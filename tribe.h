@@ -71,6 +71,7 @@ class Tribe : public Singleton<Tribe, TribeId> {
   private:
   REGISTER_HANDLER(KillEvent, const Creature* victim, const Creature* killer);
   REGISTER_HANDLER(AttackEvent, Creature* victim, Creature* attacker);
+  REGISTER_HANDLER(DiscardCreatureEvent, const Creature*);
 
   bool SERIAL(diplomatic);
 
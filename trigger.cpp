@@ -243,8 +243,13 @@ class MeteorShower : public Trigger {
   MeteorShower(Creature* c, double duration) : Trigger(c->getLevel(), c->getPosition()), creature(c),
       endTime(creature->getTime() + duration) {}
 
+  REGISTER_HANDLER(DiscardCreatureEvent, const Creature* c) {
+    if (c == creature)
+      creature = nullptr;
+  }
+
   virtual void tick(double time) override {
-    if (time >= endTime || creature->isDead()) {
+    if (time >= endTime || !creature || creature->isDead()) {
       level->getSquare(position)->removeTrigger(this);
       return;
     } else
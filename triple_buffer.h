@@ -0,0 +1,63 @@
+/* Copyright (C) 2013-2014 Michal Brzozowski (rusolis@poczta.fm)
+
+   This file is part of KeeperRL.
+
+   KeeperRL is free software; you can redistribute it and/or modify it under the terms of the
+   GNU General Public License as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   KeeperRL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+   even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with this program.
+   If not, see http://www.gnu.org/licenses/ . */
+
+#ifndef _TRIPLE_BUFFER_H
+#define _TRIPLE_BUFFER_H
+
+#include "util.h"
+
+/** Passes values from one producer thread to one consumer thread without locking. The producer fills
+ the write buffer and publishes it, the consumer picks up the latest published buffer. Neither ever waits,
+ and the buffer being read is never handed out for writing.*/
+template <class T>
+class TripleBuffer {
+  public:
+  /** Producer only. The returned buffer contains whatever was published two or more times ago.*/
+  T& getWriteBuffer() {
+    return buffers[writeIndex];
+  }
+
+  /** Producer only. Makes the write buffer available to the consumer.*/
+  void publish() {
+    writeIndex = middle.exchange(writeIndex | freshBit) & indexMask;
+  }
+
+  /** Consumer only. Switches to the latest published buffer, if there is one. Returns true if the buffer changed.*/
+  bool update() {
+    if (!(middle.load() & freshBit))
+      return false;
+    readIndex = middle.exchange(readIndex) & indexMask;
+    return true;
+  }
+
+  /** Consumer only.*/
+  T& getReadBuffer() {
+    return buffers[readIndex];
+  }
+
+  const T& getReadBuffer() const {
+    return buffers[readIndex];
+  }
+
+  private:
+  const static int indexMask = 3;
+  const static int freshBit = 4;
+  T buffers[3];
+  int writeIndex = 0;
+  int readIndex = 1;
+  std::atomic<int> middle {2};
+};
+
+#endif
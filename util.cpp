@@ -20,8 +20,30 @@
 
 void RandomGen::init(int seed) {
   generator.seed(seed);
+  shuffleMap.clear();
 }
 
+int RandomGen::getSeed() {
+  return getRandom(std::numeric_limits<int>::max());
+}
+
+template <class Archive>
+void RandomGen::save(Archive& ar, const unsigned int version) const {
+  std::stringstream ss;
+  ss << generator;
+  string engine = ss.str();
+  ar << BOOST_SERIALIZATION_NVP(engine) << BOOST_SERIALIZATION_NVP(shuffleMap);
+}
+
+template <class Archive>
+void RandomGen::load(Archive& ar, const unsigned int version) {
+  string engine;
+  ar >> BOOST_SERIALIZATION_NVP(engine) >> BOOST_SERIALIZATION_NVP(shuffleMap);
+  std::stringstream(engine) >> generator;
+}
+
+SERIALIZABLE(RandomGen);
+
 int RandomGen::getRandom(int max) {
   return getRandom(0, max);
 }
@@ -103,7 +125,16 @@ double RandomGen::getDouble(double a, double b) {
   return uniform_real_distribution<double>(a, b)(generator);
 }
 
-RandomGen Random;
+thread_local RandomGen Random;
+
+RandomStream::RandomStream(int seed) : saved(Random) {
+  Random = RandomGen();
+  Random.init(seed);
+}
+
+RandomStream::~RandomStream() {
+  Random = saved;
+}
 
 template string convertToString<int>(const int&);
 template string convertToString<size_t>(const size_t&);
@@ -550,6 +581,10 @@ Vec2 Rectangle::getBottomLeft() const {
   return Vec2(px, ky);
 }
 
+bool Rectangle::operator == (const Rectangle& other) const {
+  return px == other.px && py == other.py && kx == other.kx && ky == other.ky;
+}
+
 bool Rectangle::intersects(const Rectangle& other) const {
   return max(px, other.px) < min(kx, other.kx) && max(py, other.py) < min(ky, other.ky);
 }
@@ -707,6 +742,33 @@ void Semaphore::v() {
   cond.notify_one();
 }
 
+void runInParallel(const vector<function<void()>>& tasks) {
+  vector<int> seeds;
+  for (int i : All(tasks))
+    seeds.push_back(Random.getSeed());
+  vector<std::exception_ptr> errors(tasks.size());
+  std::atomic<int> next(0);
+  auto worker = [&] {
+    for (int i = next++; i < tasks.size(); i = next++)
+      try {
+        RandomStream stream(seeds[i]);
+        tasks[i]();
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+  };
+  int numThreads = min<int>(tasks.size(), max<int>(1, thread::hardware_concurrency()));
+  vector<thread> threads;
+  for (int i : Range(numThreads - 1))
+    threads.emplace_back(worker);
+  worker();
+  for (thread& t : threads)
+    t.join();
+  for (auto& error : errors)
+    if (error)
+      std::rethrow_exception(error);
+}
+
 AsyncLoop::AsyncLoop(function<void()> f) : AsyncLoop([]{}, f) {
 }
 
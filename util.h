@@ -203,6 +203,7 @@ class Rectangle {
   Vec2 getTopRight() const;
   Vec2 getBottomLeft() const;
 
+  bool operator == (const Rectangle&) const;
   bool intersects(const Rectangle& other) const;
   bool contains(const Rectangle& other) const;
   Rectangle intersection(const Rectangle& other) const;
@@ -288,6 +289,16 @@ class RandomGen {
   bool roll(int chance);
   bool rollD(double chance);
 
+  /** Returns a seed for an independent stream. Seeds drawn in a fixed order give the same streams for a given
+   master seed.*/
+  int getSeed();
+
+  template <class Archive>
+  void save(Archive& ar, const unsigned int version) const;
+  template <class Archive>
+  void load(Archive& ar, const unsigned int version);
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+
   private:
   void makeShuffle(string id, int min, int max);
   default_random_engine generator;
@@ -296,11 +307,28 @@ class RandomGen {
     int minRange;
     int maxRange;
     vector<int> numbers;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int version) {
+      ar & BOOST_SERIALIZATION_NVP(minRange) & BOOST_SERIALIZATION_NVP(maxRange) & BOOST_SERIALIZATION_NVP(numbers);
+    }
   };
   unordered_map<string, ShuffleInfo> shuffleMap;
 };
 
-extern RandomGen Random;
+/** Every thread has its own generator, so that work done on other threads doesn't touch the game's sequence.*/
+extern thread_local RandomGen Random;
+
+/** Switches the calling thread's Random to a stream seeded for one job and restores it when destroyed. A job that
+ draws only from its own stream gives the same result on any thread, in any order.*/
+class RandomStream {
+  public:
+  RandomStream(int seed);
+  ~RandomStream();
+
+  private:
+  RandomGen saved;
+};
 
 inline Debug& operator <<(Debug& d, Rectangle rect) {
   return d << "(" << rect.getPX() << "," << rect.getPY() << ") (" << rect.getKX() << "," << rect.getKY() << ")";
@@ -397,16 +425,17 @@ class Table {
   template <class Archive> 
   void save(Archive& ar, const unsigned int version) const {
     ar << BOOST_SERIALIZATION_NVP(bounds);
-    for (Vec2 v : bounds)
-      ar << boost::serialization::make_nvp("Elem", (*this)[v]);
+    saveElems(ar, IsBinary());
   }
 
   template <class Archive> 
   void load(Archive& ar, const unsigned int version) {
     ar >> BOOST_SERIALIZATION_NVP(bounds);
     mem.reset(new T[bounds.getW() * bounds.getH()]);
-    for (Vec2 v : bounds)
-      ar >> boost::serialization::make_nvp("Elem", (*this)[v]);
+    if (version == 0)
+      loadElems(ar, std::false_type());
+    else
+      loadElems(ar, IsBinary());
   }
 
   BOOST_SERIALIZATION_SPLIT_MEMBER()
@@ -414,10 +443,62 @@ class Table {
   SERIALIZATION_CONSTRUCTOR(Table);
 
   private:
+  /** Numbers and enums are saved as one binary block instead of element by element. Structs still go through
+   the archive, so that their padding bytes don't end up in the save.*/
+  typedef std::integral_constant<bool, std::is_arithmetic<T>::value || std::is_enum<T>::value> IsBinary;
+
+  template <class Archive> 
+  void saveElems(Archive& ar, std::false_type) const {
+    for (Vec2 v : bounds)
+      ar << boost::serialization::make_nvp("Elem", (*this)[v]);
+  }
+
+  template <class Archive> 
+  void loadElems(Archive& ar, std::false_type) {
+    for (Vec2 v : bounds)
+      ar >> boost::serialization::make_nvp("Elem", (*this)[v]);
+  }
+
+  template <class Archive> 
+  void saveElems(Archive& ar, std::true_type) const {
+    char littleEndian = isLittleEndian();
+    int elemSize = sizeof(T);
+    ar << BOOST_SERIALIZATION_NVP(littleEndian) << BOOST_SERIALIZATION_NVP(elemSize);
+    ar.save_binary(mem.get(), bounds.getW() * bounds.getH() * sizeof(T));
+  }
+
+  template <class Archive> 
+  void loadElems(Archive& ar, std::true_type) {
+    char littleEndian;
+    int elemSize;
+    ar >> BOOST_SERIALIZATION_NVP(littleEndian) >> BOOST_SERIALIZATION_NVP(elemSize);
+    if (littleEndian != isLittleEndian() || elemSize != sizeof(T))
+      throw boost::archive::archive_exception(
+          boost::archive::archive_exception::incompatible_native_format, "Table");
+    ar.load_binary(mem.get(), bounds.getW() * bounds.getH() * sizeof(T));
+  }
+
+  static char isLittleEndian() {
+    int one = 1;
+    return *(char*)&one;
+  }
+
   Rectangle bounds;
   unique_ptr<T[]> mem;
 };
 
+namespace boost {
+namespace serialization {
+// Version 1 stores plain data tables in one block.
+template <class T>
+struct version<Table<T>> {
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+}
+}
+
 template<typename T>
 class DirtyTable {
   public:
@@ -721,6 +802,10 @@ class Optional {
     return !elem.empty() && elem.front() == t;
   }
 
+  bool operator == (const Optional<T>& t) const {
+    return elem == t.elem;
+  }
+
   bool operator != (const T& t) const {
     return elem.empty() || elem.front() != t;
   }
@@ -1350,6 +1435,45 @@ class SyncQueue {
   queue<T> q;
 };
 
+/** A queue for passing elements between threads. Pushing blocks while the queue is full.*/
+template <class T>
+class BoundedQueue {
+  public:
+  BoundedQueue(int cap) : capacity(cap) {}
+
+  T pop() {
+    std::unique_lock<std::mutex> lock(mut);
+    while (q.empty())
+      notEmpty.wait(lock);
+    T ret = std::move(q.front());
+    q.pop();
+    lock.unlock();
+    notFull.notify_one();
+    return ret;
+  }
+
+  void push(T t) {
+    std::unique_lock<std::mutex> lock(mut);
+    while (q.size() >= capacity)
+      notFull.wait(lock);
+    q.push(std::move(t));
+    lock.unlock();
+    notEmpty.notify_one();
+  }
+
+  private:
+  int capacity;
+  std::mutex mut;
+  std::condition_variable notEmpty;
+  std::condition_variable notFull;
+  queue<T> q;
+};
+
+/** Runs the tasks on as many threads as there are cores and waits for all of them. Every task draws from its own
+ random stream, seeded in order on the calling thread, so the results don't depend on scheduling. If tasks throw,
+ the exception of the first of them is rethrown.*/
+void runInParallel(const vector<function<void()>>& tasks);
+
 class AsyncLoop {
   public:
   AsyncLoop(function<void()> init, function<void()> loop);
@@ -47,6 +47,12 @@ ViewObject::ViewObject(ViewId id, ViewLayer l, const string& d)
     setAttribute(attr, -1);
 }
 
+bool ViewObject::operator == (const ViewObject& o) const {
+  return resource_id == o.resource_id && viewLayer == o.viewLayer && enemyStatus == o.enemyStatus
+      && modifiers == o.modifiers && attributes == o.attributes && description == o.description
+      && attachmentDir == o.attachmentDir;
+}
+
 ViewObject& ViewObject::setModifier(Modifier mod) {
   modifiers[mod] = true;
   return *this;
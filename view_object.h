@@ -64,6 +64,8 @@ class ViewObject {
   ViewId id() const;
   void setId(ViewId);
 
+  bool operator == (const ViewObject&) const;
+
   const static ViewObject& unknownMonster();
   const static ViewObject& empty();
   const static ViewObject& mana();
@@ -23,6 +23,7 @@
 #include "creature.h"
 #include "collective.h"
 #include "pantheon.h"
+#include "entity_set.h"
 
 template <class Archive>
 void VillageControl::serialize(Archive& ar, const unsigned int version) {
@@ -125,22 +126,34 @@ class AttackTriggerSet : public AttackTrigger {
   AttackTriggerSet(VillageControl* c) : AttackTrigger(c) {}
 
   virtual bool startedAttack(const Creature* c) override {
-    return fightingCreatures.count(c);
+    return fightingCreatures.contains(c);
   }
 
   SERIALIZATION_CONSTRUCTOR(AttackTriggerSet);
 
   template <class Archive>
   void serialize(Archive& ar, const unsigned int version) {
-    ar& SUBCLASS(AttackTrigger)
-      & SVAR(fightingCreatures);
+    ar& SUBCLASS(AttackTrigger);
+    if (version == 0) {
+      set<const Creature*> oldFighting;
+      ar & boost::serialization::make_nvp("fightingCreatures", oldFighting);
+      Serialization::afterLoad([=] {
+        for (const Creature* c : oldFighting)
+          fightingCreatures.insert(c);
+      });
+      SKIP_SERIAL(fightingCreatures);
+    } else
+      ar & SVAR(fightingCreatures);
     CHECK_SERIAL;
   }
 
   protected:
-  set<const Creature*> SERIAL(fightingCreatures);
+  EntitySet<Creature> SERIAL(fightingCreatures);
 };
 
+// Version 1 keeps ids of the creatures that attacked.
+BOOST_CLASS_VERSION(AttackTriggerSet, 1)
+
 class PowerTrigger : public AttackTriggerSet {
   public:
   // How long to wait between being attacked and attacking
@@ -197,7 +210,7 @@ class PowerTrigger : public AttackTriggerSet {
       return;
     double lastAttackPoints = 0;
     for (const Creature* c : control->getCreatures(MinionTrait::FIGHTER))
-      if (fightingCreatures.count(c))
+      if (fightingCreatures.contains(c))
         lastAttackPoints += c->getDifficultyPoints();
     bool firstAttack = lastAttackPoints == 0;
     double currentTrigger = getCurrentTrigger(time);
@@ -205,7 +218,7 @@ class PowerTrigger : public AttackTriggerSet {
       lastMyAttack = time;
       int numCreatures = 0;
       for (const Creature* c : getSorted(control->getCreatures(MinionTrait::FIGHTER)))
-        if (!fightingCreatures.count(c) && !c->isDead()) {
+        if (!fightingCreatures.contains(c) && !c->isDead()) {
           ++numCreatures;
           fightingCreatures.insert(c);
           if ((lastAttackPoints += c->getDifficultyPoints()) >= currentTrigger)
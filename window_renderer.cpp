@@ -19,12 +19,17 @@
 using namespace sf;
 
 void WindowRenderer::drawAndClearBuffer() {
+  finishFrame();
+  if (!display)
+    return;
   display->display();
   display->clear(Color(0, 0, 0));
 }
 
 void WindowRenderer::resize(int width, int height) {
-  display->setView(*(sfView = new sf::View(sf::FloatRect(0, 0, width, height))));
+  flush();
+  if (display)
+    display->setView(*(sfView = new sf::View(sf::FloatRect(0, 0, width, height))));
 }
 
 void WindowRenderer::initialize(int width, int height, string title) {
@@ -33,6 +38,10 @@ void WindowRenderer::initialize(int width, int height, string title) {
   Renderer::initialize(display, width, height);
 }
 
+void WindowRenderer::initializeHeadless(int width, int height) {
+  Renderer::initialize(nullptr, width, height);
+}
+
 Event WindowRenderer::getRandomEvent() {
   Event::EventType type = Event::EventType(Random.getRandom(int(Event::Count)));
   Event ret;
@@ -64,7 +73,7 @@ bool WindowRenderer::pollEvent(Event& event, Event::EventType type) {
       return true;
     }
   Event ev;
-  while (display->pollEvent(ev)) {
+  while (display && display->pollEvent(ev)) {
     if (ev.type != type)
       eventQueue.push_back(ev);
     else {
@@ -86,12 +95,12 @@ bool WindowRenderer::pollEvent(Event& ev) {
       eventQueue.pop_front();
       return true;
   } else
-    return display->pollEvent(ev);
+    return display && display->pollEvent(ev);
 }
 
 void WindowRenderer::flushEvents(Event::EventType type) {
   Event ev;
-  while (display->pollEvent(ev)) {
+  while (display && display->pollEvent(ev)) {
     if (ev.type != type)
       eventQueue.push_back(ev);
   }
@@ -99,7 +108,7 @@ void WindowRenderer::flushEvents(Event::EventType type) {
 
 void WindowRenderer::flushAllEvents() {
   Event ev;
-  while (display->pollEvent(ev));
+  while (display && display->pollEvent(ev));
 }
 
 void WindowRenderer::waitEvent(Event& ev) {
@@ -110,14 +119,18 @@ void WindowRenderer::waitEvent(Event& ev) {
     if (!eventQueue.empty()) {
       ev = eventQueue.front();
       eventQueue.pop_front();
-    } else
+    } else {
+      CHECK(display) << "Waiting for events without a window";
       display->waitEvent(ev);
+    }
   }
 }
 
 Vec2 WindowRenderer::getMousePos() {
   if (monkey)
     return Vec2(Random.getRandom(getWidth()), Random.getRandom(getHeight()));
+  if (!display)
+    return Vec2(-1, -1);
   auto pos = Mouse::getPosition(*display);
   return Vec2(pos.x, pos.y);
 }
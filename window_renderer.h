@@ -33,6 +33,8 @@ using sf::Event;
 class WindowRenderer : public Renderer {
   public: 
   void initialize(int width, int height, string title);
+  /** Initializes without opening a window. Nothing is drawn and there are no events.*/
+  void initializeHeadless(int width, int height);
   void drawAndClearBuffer();
   void resize(int width, int height);
   bool pollEvent(Event&, Event::EventType);
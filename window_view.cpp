@@ -26,6 +26,7 @@
 #include "tile.h"
 #include "clock.h"
 #include "creature_view.h"
+#include "square.h"
 
 using sf::Color;
 using sf::String;
@@ -82,7 +83,7 @@ int bottomBarHeightPlayer = 62;
 WindowRenderer renderer;
 
 Rectangle WindowView::getMapGuiBounds() const {
-  switch (gameInfo.infoType) {
+  switch (infoType) {
     case GameInfo::InfoType::PLAYER:
       return Rectangle(0, 0, renderer.getWidth() - rightBarWidthPlayer, renderer.getHeight() - bottomBarHeightPlayer);
     case GameInfo::InfoType::BAND:
@@ -116,6 +117,42 @@ bool WindowView::areTilesOk() {
 
 void WindowView::initialize() {
   renderer.initialize(1024, 600, "KeeperRL");
+  initializeInt();
+}
+
+void WindowView::initializeHeadless(int width, int height) {
+  renderer.initializeHeadless(width, height);
+  initializeInt();
+}
+
+WindowView::RenderStats WindowView::benchmarkRendering(const CreatureView* view, int numFrames) {
+  CHECK(numFrames > 0);
+  CHECK(std::this_thread::get_id() == renderThreadId);
+  // updateView only runs off the render thread, like in the game.
+  thread gameThread([&] { updateView(view); });
+  gameThread.join();
+  vector<Renderer::Command> commands;
+  RenderStats ret {numFrames, 0, 0, 0, 0};
+  for (int i : Range(numFrames)) {
+    commands.clear();
+    renderer.setRecording(&commands);
+    sf::Clock clock;
+    refreshView();
+    double millis = double(clock.getElapsedTime().asMicroseconds()) / 1000;
+    renderer.setRecording(nullptr);
+    ret.commandsPerFrame += commands.size();
+    for (auto& command : commands)
+      ret.verticesPerFrame += command.vertices;
+    ret.millisPerFrame += millis;
+    ret.maxMillis = max(ret.maxMillis, millis);
+  }
+  ret.commandsPerFrame /= numFrames;
+  ret.verticesPerFrame /= numFrames;
+  ret.millisPerFrame /= numFrames;
+  return ret;
+}
+
+void WindowView::initializeInt() {
   Clock::set(new Clock());
   renderThreadId = std::this_thread::get_id();
   Renderer::setNominalSize(Vec2(36, 36));
@@ -149,7 +186,7 @@ void WindowView::initialize() {
     Tile::loadTiles();
   } else
     currentTileLayout = asciiLayouts;
-  mapGui = new MapGui(objects,
+  mapGui = new MapGui(
       [this](Vec2 pos) { mapLeftClickFun(pos); },
       [this](Vec2 pos) { mapRightClickFun(pos); },
       [this] { refreshInput = true;} );
@@ -161,7 +198,7 @@ void WindowView::initialize() {
 
 void WindowView::mapLeftClickFun(Vec2 pos) {
   chosenCreature = "";
-  switch (gameInfo.infoType) {
+  switch (infoType) {
     case GameInfo::InfoType::PLAYER:
       inputQueue.push(UserInput(UserInputId::MOVE_TO, pos));
       break;
@@ -179,7 +216,7 @@ void WindowView::mapLeftClickFun(Vec2 pos) {
 }
 
 void WindowView::mapRightClickFun(Vec2 pos) {
-  switch (gameInfo.infoType) {
+  switch (infoType) {
     case GameInfo::InfoType::BAND:
       inputQueue.push(UserInput(UserInputId::POSSESS, pos));
       break;
@@ -388,7 +425,16 @@ PGuiElem WindowView::drawPlayerHelp(GameInfo::PlayerInfo& info) {
   return GuiElem::verticalList(std::move(lines), legendLineHeight, 0);
 }
 
-PGuiElem WindowView::drawRightPlayerInfo(GameInfo::PlayerInfo& info) {
+template <class Key>
+PGuiElem WindowView::getCachedGui(CachedGui<Key>& cache, const Key& key, function<PGuiElem()> build) {
+  if (!cache.elem || !(cache.key == key)) {
+    cache.elem = build();
+    cache.key = key;
+  }
+  return GuiElem::external(cache.elem.get());
+}
+
+PGuiElem WindowView::drawRightPlayerInfo(GameInfo::PlayerInfo& info, GuiCache& cache) {
   vector<PGuiElem> buttons = makeVec<PGuiElem>(
     GuiElem::icon(GuiElem::MINION),
     GuiElem::icon(GuiElem::HELP));
@@ -402,8 +448,10 @@ PGuiElem WindowView::drawRightPlayerInfo(GameInfo::PlayerInfo& info) {
   }
   PGuiElem main;
   vector<pair<MinionTab, PGuiElem>> elems = makeVec<pair<MinionTab, PGuiElem>>(
-    make_pair(MinionTab::STATS, drawPlayerStats(info)),
-    make_pair(MinionTab::HELP, drawPlayerHelp(info)));
+    make_pair(MinionTab::STATS, getCachedGui(cache.playerStats,
+        make_tuple(info.weaponName, info.attributes, info.skills, info.effects),
+        [&] { return drawPlayerStats(info); })),
+    make_pair(MinionTab::HELP, getCachedGui(cache.playerHelp, 0, [&] { return drawPlayerHelp(info); })));
   for (auto& elem : elems)
     if (elem.first == minionTab)
       main = std::move(elem.second);
@@ -542,9 +590,6 @@ PGuiElem WindowView::drawMinions(GameInfo::BandInfo& info) {
       list.push_back(GuiElem::horizontalList(std::move(line), 20, 0));
     }
   }
-  if (!creatureMap.count(chosenCreature)) {
-    chosenCreature = "";
-  }
   return GuiElem::verticalList(std::move(list), legendLineHeight, 0);
 }
 
@@ -779,7 +824,8 @@ PGuiElem WindowView::drawBottomBandInfo(GameInfo& gameInfo) {
         GuiElem::centerHoriz(GuiElem::horizontalList(std::move(bottomLine), 140, 0, 3), numBottom * 140)), 28, 0);
 }
 
-PGuiElem WindowView::drawRightBandInfo(GameInfo::BandInfo& info, GameInfo::VillageInfo& villageInfo) {
+PGuiElem WindowView::drawRightBandInfo(GameInfo::BandInfo& info, GameInfo::VillageInfo& villageInfo,
+    GuiCache& cache) {
   vector<PGuiElem> buttons = makeVec<PGuiElem>(
     GuiElem::icon(GuiElem::BUILDING),
     GuiElem::icon(GuiElem::MINION),
@@ -795,17 +841,26 @@ PGuiElem WindowView::drawRightBandInfo(GameInfo::BandInfo& info, GameInfo::Villa
     buttons[i] = GuiElem::stack(std::move(buttons[i]),
         GuiElem::button([this, i]() { setCollectiveTab(CollectiveTab(i)); }));
   }
-  if (collectiveTab != CollectiveTab::MINIONS)
+  // The chosen creature is a part of the cache key, so it's reset before the cache is checked.
+  if (collectiveTab != CollectiveTab::MINIONS || !getCreatureMap(info.minions).count(chosenCreature))
     chosenCreature = "";
   PGuiElem main;
   vector<PGuiElem> invisible;
   vector<pair<CollectiveTab, PGuiElem>> elems = makeVec<pair<CollectiveTab, PGuiElem>>(
-    make_pair(CollectiveTab::MINIONS, drawMinions(info)),
-    make_pair(CollectiveTab::BUILDINGS, drawBuildings(info)),
-    make_pair(CollectiveTab::KEY_MAPPING, drawKeeperHelp()),
-    make_pair(CollectiveTab::TECHNOLOGY, drawTechnology(info)),
-    make_pair(CollectiveTab::WORKSHOP, drawDeities(info)),
-    make_pair(CollectiveTab::VILLAGES, drawVillages(villageInfo)));
+    make_pair(CollectiveTab::MINIONS, getCachedGui(cache.minions,
+        make_tuple(info.minions, info.enemies, info.monsterHeader, info.teams, info.currentTeam,
+            info.numResource[0].viewObject, info.nextPayout, info.payoutTimeRemaining, chosenCreature),
+        [&] { return drawMinions(info); })),
+    make_pair(CollectiveTab::BUILDINGS, getCachedGui(cache.buildings, make_tuple(info.buildings, activeBuilding),
+        [&] { return drawBuildings(info); })),
+    make_pair(CollectiveTab::KEY_MAPPING, getCachedGui(cache.keeperHelp, 0, [&] { return drawKeeperHelp(); })),
+    make_pair(CollectiveTab::TECHNOLOGY, getCachedGui(cache.technology,
+        make_tuple(info.libraryButtons, info.techButtons, activeLibrary),
+        [&] { return drawTechnology(info); })),
+    make_pair(CollectiveTab::WORKSHOP, getCachedGui(cache.deities, info.deities,
+        [&] { return drawDeities(info); })),
+    make_pair(CollectiveTab::VILLAGES, getCachedGui(cache.villages, villageInfo.villages,
+        [&] { return drawVillages(villageInfo); })));
   for (auto& elem : elems)
     if (elem.first == collectiveTab)
       main = std::move(elem.second);
@@ -824,6 +879,15 @@ PGuiElem WindowView::drawRightBandInfo(GameInfo::BandInfo& info, GameInfo::Villa
         GuiElem::label("ZOOM", colors[ColorId::LIGHT_BLUE])));
   bottomLine.push_back(
       GuiElem::label("FPS " + convertToString(fpsCounter.getFps()), colors[ColorId::WHITE]));
+#ifndef RELEASE
+  Renderer::Stats renderStats;
+  {
+    RenderLock lock(renderMutex);
+    renderStats = renderer.getFrameStats();
+  }
+  bottomLine.push_back(GuiElem::label("DRAWS " + convertToString(renderStats.drawCalls),
+        colors[ColorId::WHITE]));
+#endif
   main = GuiElem::margin(GuiElem::margins(GuiElem::horizontalList(std::move(bottomLine), 90, 0), 30, 0, 0, 0),
       std::move(main), 48, GuiElem::BOTTOM);
   return GuiElem::stack(GuiElem::stack(std::move(invisible)),
@@ -834,50 +898,56 @@ const int minionWindowRightMargin = 20;
 const int minionWindowWidth = 340;
 const int minionWindowHeight = 600;
 
-void WindowView::rebuildGui() {
+void WindowView::rebuildGui(FrameSnapshot& frame, Vec2 screenSize) {
+  GameInfo& gameInfo = frame.gameInfo;
   PGuiElem bottom, right, overMap;
   int rightBarWidth = 0;
   int bottomBarHeight = 0;
   switch (gameInfo.infoType) {
     case GameInfo::InfoType::PLAYER:
-        right = drawRightPlayerInfo(gameInfo.playerInfo);
+        right = drawRightPlayerInfo(gameInfo.playerInfo, frame.guiCache);
         bottom = drawBottomPlayerInfo(gameInfo);
         rightBarWidth = rightBarWidthPlayer;
         bottomBarHeight = bottomBarHeightPlayer;
         break;
     case GameInfo::InfoType::BAND:
-        right = drawRightBandInfo(gameInfo.bandInfo, gameInfo.villageInfo);
-        overMap = drawMinionWindow(gameInfo.bandInfo);
+        right = drawRightBandInfo(gameInfo.bandInfo, gameInfo.villageInfo, frame.guiCache);
+        if (chosenCreature != "") {
+          GameInfo::BandInfo& info = gameInfo.bandInfo;
+          overMap = getCachedGui(frame.guiCache.minionWindow,
+              make_tuple(chosenCreature, info.minions, info.tasks, info.currentTeam, info.teams),
+              [&] { return drawMinionWindow(info); });
+        }
         bottom = drawBottomBandInfo(gameInfo);
         rightBarWidth = rightBarWidthCollective;
         bottomBarHeight = bottomBarHeightCollective;
         break;
   }
-  resetMapBounds();
   CHECK(std::this_thread::get_id() != renderThreadId);
-  tempGuiElems.clear();
-  tempGuiElems.push_back(GuiElem::mainDecoration(rightBarWidth, bottomBarHeight));
-  tempGuiElems.back()->setBounds(Rectangle(renderer.getWidth(), renderer.getHeight()));
-  tempGuiElems.push_back(//GuiElem::stack(GuiElem::background(GuiElem::background2), 
+  int width = screenSize.x;
+  int height = screenSize.y;
+  vector<PGuiElem>& guiElems = frame.guiElems;
+  guiElems.clear();
+  guiElems.push_back(GuiElem::mainDecoration(rightBarWidth, bottomBarHeight));
+  guiElems.back()->setBounds(Rectangle(width, height));
+  guiElems.push_back(//GuiElem::stack(GuiElem::background(GuiElem::background2), 
         GuiElem::margins(std::move(right), 20, 20, 10, 0));
-  tempGuiElems.back()->setBounds(Rectangle(
-        renderer.getWidth() - rightBarWidth, 0, renderer.getWidth(), renderer.getHeight()));
-  tempGuiElems.push_back(//GuiElem::stack(GuiElem::background(GuiElem::background2),
+  guiElems.back()->setBounds(Rectangle(width - rightBarWidth, 0, width, height));
+  guiElems.push_back(//GuiElem::stack(GuiElem::background(GuiElem::background2),
         GuiElem::margins(std::move(bottom), 80, 10, 80, 0));
-  tempGuiElems.back()->setBounds(Rectangle(
-        0, renderer.getHeight() - bottomBarHeight, renderer.getWidth() - rightBarWidth, renderer.getHeight()));
+  guiElems.back()->setBounds(Rectangle(0, height - bottomBarHeight, width - rightBarWidth, height));
   if (overMap) {
-    tempGuiElems.push_back(GuiElem::window(GuiElem::stack(GuiElem::background(GuiElem::background2), 
+    guiElems.push_back(GuiElem::window(GuiElem::stack(GuiElem::background(GuiElem::background2), 
           GuiElem::margins(std::move(overMap), 20, 20, 20, 20))));
-    tempGuiElems.back()->setBounds(Rectangle(
-          renderer.getWidth() - rightBarWidth - minionWindowWidth - minionWindowRightMargin, 100,
-          renderer.getWidth() - rightBarWidth - minionWindowRightMargin, 100 + minionWindowHeight));
+    guiElems.back()->setBounds(Rectangle(
+          width - rightBarWidth - minionWindowWidth - minionWindowRightMargin, 100,
+          width - rightBarWidth - minionWindowRightMargin, 100 + minionWindowHeight));
   }
 }
 
 vector<GuiElem*> WindowView::getAllGuiElems() {
   CHECK(std::this_thread::get_id() == renderThreadId);
-  vector<GuiElem*> ret = extractRefs(tempGuiElems);
+  vector<GuiElem*> ret = extractRefs(frames.getReadBuffer().guiElems);
   if (gameReady)
     ret = concat(concat({mapGui}, ret), {minimapDecoration.get(), minimapGui});
   return ret;
@@ -885,7 +955,7 @@ vector<GuiElem*> WindowView::getAllGuiElems() {
 
 vector<GuiElem*> WindowView::getClickableGuiElems() {
   CHECK(std::this_thread::get_id() == renderThreadId);
-  vector<GuiElem*> ret = extractRefs(tempGuiElems);
+  vector<GuiElem*> ret = extractRefs(frames.getReadBuffer().guiElems);
   ret = getSuffix(ret, ret.size() - 1);
   if (gameReady) {
     ret.push_back(minimapGui);
@@ -1012,21 +1082,61 @@ void WindowView::updateMinimap(const CreatureView* creature) {
     minimapGui->update(level, bounds, creature);
 }
 
+bool WindowView::TileVersion::operator == (const TileVersion& other) const {
+  return squareVersion == other.squareVersion && visible == other.visible && light == other.light
+      && overlayVersion == other.overlayVersion;
+}
+
 void WindowView::updateView(const CreatureView* collective) {
-  RenderLock lock(renderMutex);
-  updateMinimap(collective);
-  gameReady = true;
-  switchTiles();
+  FrameSnapshot& frame = frames.getWriteBuffer();
+  collective->refreshGameInfo(frame.gameInfo);
   const Level* level = collective->getViewLevel();
-  collective->refreshGameInfo(gameInfo);
-  for (Vec2 pos : mapLayout->getAllTiles(getMapGuiBounds(), Level::getMaxBounds()))
-    objects[pos] = Nothing();
-  if (!mapGui->isCentered() || collective->staticPosition())
-    mapGui->setCenter(collective->getPosition());
   const MapMemory* memory = &collective->getMemory(); 
-  mapGui->updateLayout(mapLayout, collective->getViewLevel()->getBounds());
-  for (Vec2 pos : mapLayout->getAllTiles(getMapGuiBounds(), Level::getMaxBounds())) 
+  Rectangle tiles;
+  Vec2 screenSize;
+  {
+    // The view of the map is only computed under the lock, it reaches the MapGui with the snapshot.
+    // The tiles are built while the render thread keeps drawing the previous snapshot.
+    RenderLock lock(renderMutex);
+    infoType = frame.gameInfo.infoType;
+    updateMinimap(collective);
+    switchTiles();
+    frame.center = Nothing();
+    if (!mapGui->isCentered() || collective->staticPosition())
+      frame.center = collective->getPosition();
+    frame.layout = mapLayout;
+    frame.levelBounds = level->getBounds();
+    frame.layoutPos = mapGui->getLayoutPos(mapLayout, frame.center, frame.levelBounds);
+    mapGui->setSpriteMode(currentTileLayout.sprites);
+    resetMapBounds();
+    MapLayout layout = *mapLayout;
+    layout.updatePlayerPos(frame.layoutPos);
+    tiles = layout.getAllTiles(getMapGuiBounds(), Level::getMaxBounds());
+    screenSize = Vec2(renderer.getWidth(), renderer.getHeight());
+  }
+  ++frameCount;
+  if (!(tiles == tileVersions.getBounds()) || collective != lastView || level != lastLevel || memory != lastMemory
+      || memory->getEditCount() != lastMemoryEdits) {
+    for (Vec2 pos : tileVersions.getBounds())
+      objects[pos] = Nothing();
+    tileVersions = Table<TileVersion>(tiles, TileVersion{-1, false, 0, -1});
+    tileUpdates = Table<int>(tiles, frameCount);
+    lastView = collective;
+    lastLevel = level;
+    lastMemory = memory;
+    lastMemoryEdits = memory->getEditCount();
+  }
+  int overlayVersion = collective->getOverlayVersion();
+  for (Vec2 pos : tiles) 
     if (level->inBounds(pos)) {
+      const Square* square = level->getSquare(pos);
+      TileVersion version {square->getVersion(), collective->canSee(pos), level->getLight(pos), overlayVersion};
+      // creatures change their appearance without touching the square, so their tiles are always refreshed
+      if (version == tileVersions[pos] && !square->getCreature()
+          && (!objects[pos] || !objects[pos]->hasObject(ViewLayer::CREATURE)))
+        continue;
+      tileVersions[pos] = version;
+      tileUpdates[pos] = frameCount;
       ViewIndex index;
       collective->getViewIndex(pos, index);
       if (!index.hasObject(ViewLayer::FLOOR) && !index.hasObject(ViewLayer::FLOOR_BACKGROUND) &&
@@ -1039,13 +1149,28 @@ void WindowView::updateView(const CreatureView* collective) {
       }
       if (index.isEmpty() && memory->hasViewIndex(pos))
         index = memory->getViewIndex(pos);
-      index.setHighlight(HighlightType::NIGHT, 1.0 - collective->getViewLevel()->getLight(pos));
+      index.setHighlight(HighlightType::NIGHT, 1.0 - version.light);
       objects[pos] = index;
     }
-  mapGui->setSpriteMode(currentTileLayout.sprites);
-  mapGui->updateObjects(memory);
-  mapGui->setLevelBounds(level->getBounds());
-  rebuildGui();
+  // The write buffer was last filled a few frames ago, so only tiles recomputed since then are copied.
+  if (!(frame.objects.getBounds() == tiles)) {
+    frame.objects = Table<Optional<ViewIndex>>(tiles);
+    frame.tileUpdates = Table<int>(tiles);
+    frame.frame = -1;
+  }
+  for (Vec2 pos : tiles)
+    if (tileUpdates[pos] > frame.frame) {
+      frame.objects[pos] = objects[pos];
+      frame.tileUpdates[pos] = tileUpdates[pos];
+    }
+  frame.frame = frameCount;
+  frame.memory = memory;
+  // The gui is built from the chosen creature and the open tabs, which the button callbacks change
+  // in the render thread.
+  RenderLock lock(renderMutex);
+  rebuildGui(frame, screenSize);
+  frames.publish();
+  gameReady = true;
 }
 
 void WindowView::animateObject(vector<Vec2> trajectory, ViewObject object) {
@@ -1069,6 +1194,14 @@ void WindowView::animation(Vec2 pos, AnimationId id) {
 void WindowView::refreshView() {
   RenderLock lock(renderMutex);
   CHECK(std::this_thread::get_id() == renderThreadId);
+  if (frames.update()) {
+    FrameSnapshot& frame = frames.getReadBuffer();
+    if (frame.center)
+      mapGui->setCenter(*frame.center);
+    mapGui->setLevelBounds(frame.levelBounds);
+    mapGui->updateLayout(frame.layout, frame.layoutPos);
+    mapGui->updateObjects(frame.objects, frame.tileUpdates, frame.frame, frame.memory);
+  }
   if (gameReady)
     processEvents();
   if (renderDialog) {
@@ -1081,7 +1214,7 @@ void WindowView::refreshView() {
 void WindowView::drawMap() {
   for (GuiElem* gui : getAllGuiElems())
     gui->render(renderer);
-  renderMessages(gameInfo.messageBuffer);
+  renderMessages(frames.getReadBuffer().gameInfo.messageBuffer);
   fpsCounter.addTick();
 }
 
@@ -1119,7 +1252,7 @@ Optional<Vec2> WindowView::chooseDirection(const string& message) {
   TempClockPause pause;
   SyncQueue<Optional<Vec2>> returnQueue;
   addReturnDialog<Optional<Vec2>>(returnQueue, [=] ()-> Optional<Vec2> {
-  gameInfo.messageBuffer = { PlayerMessage(message) };
+  frames.getReadBuffer().gameInfo.messageBuffer = { PlayerMessage(message) };
   refreshScreen();
   do {
     Event event;
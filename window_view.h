@@ -23,6 +23,7 @@
 #include "minimap_gui.h"
 #include "input_queue.h"
 #include "animation.h"
+#include "triple_buffer.h"
 
 class ViewIndex;
 
@@ -65,8 +66,24 @@ class WindowView: public View {
   static Color getFireColor();
   static bool areTilesOk();
 
+  /** Like initialize(), but doesn't open a window. Draw calls are counted and recorded instead of drawn.*/
+  void initializeHeadless(int width, int height);
+
+  struct RenderStats {
+    int frames;
+    double commandsPerFrame;
+    double verticesPerFrame;
+    double millisPerFrame;
+    double maxMillis;
+  };
+
+  /** Publishes what the creature view sees from a separate game thread, then renders it a number of times
+      and measures the frames. Has to be called from the thread that initialized the view.*/
+  RenderStats benchmarkRendering(const CreatureView*, int numFrames);
+
   private:
 
+  void initializeInt();
   void processEvents();
   void displayMenuSplash2();
   void updateMinimap(const CreatureView*);
@@ -78,16 +95,22 @@ class WindowView: public View {
       vector<sf::Event::KeyEvent> shortCuts);
   Optional<UserInputId> getSimpleInput(sf::Event::KeyEvent key);
   void refreshViewInt(const CreatureView*, bool flipBuffer = true);
-  void rebuildGui();
+  struct FrameSnapshot;
+  void rebuildGui(FrameSnapshot&, Vec2 screenSize);
+  template <class Key>
+  struct CachedGui;
+  template <class Key>
+  PGuiElem getCachedGui(CachedGui<Key>&, const Key&, function<PGuiElem()> build);
+  struct GuiCache;
   void drawMap();
   PGuiElem getSunlightInfoGui(GameInfo::SunlightInfo& sunlightInfo);
   PGuiElem getTurnInfoGui(int turn);
   PGuiElem drawBottomPlayerInfo(GameInfo&);
-  PGuiElem drawRightPlayerInfo(GameInfo::PlayerInfo&);
+  PGuiElem drawRightPlayerInfo(GameInfo::PlayerInfo&, GuiCache&);
   PGuiElem drawPlayerStats(GameInfo::PlayerInfo&);
   PGuiElem drawPlayerHelp(GameInfo::PlayerInfo&);
   PGuiElem drawBottomBandInfo(GameInfo&);
-  PGuiElem drawRightBandInfo(GameInfo::BandInfo& info, GameInfo::VillageInfo&);
+  PGuiElem drawRightBandInfo(GameInfo::BandInfo& info, GameInfo::VillageInfo&, GuiCache&);
   PGuiElem drawBuildings(GameInfo::BandInfo& info);
   PGuiElem drawTechnology(GameInfo::BandInfo& info);
   PGuiElem drawVillages(GameInfo::VillageInfo& info);
@@ -150,15 +173,71 @@ class WindowView: public View {
 
   MinionTab minionTab = MinionTab::STATS;
 
+  // Only touched by the game thread. The render thread draws from the frame snapshots.
   Table<Optional<ViewIndex>> objects;
-  GameInfo gameInfo;
+  struct TileVersion {
+    int squareVersion;
+    bool visible;
+    double light;
+    int overlayVersion;
+    bool operator == (const TileVersion&) const;
+  };
+  // What each on-screen tile in objects was last computed from, so that updateView only redoes changed tiles.
+  Table<TileVersion> tileVersions = Table<TileVersion>(0, 0);
+  // The frame in which each on-screen tile in objects was last recomputed.
+  Table<int> tileUpdates = Table<int>(0, 0);
+  int frameCount = 0;
+  const CreatureView* lastView = nullptr;
+  const Level* lastLevel = nullptr;
+  const MapMemory* lastMemory = nullptr;
+  int lastMemoryEdits = 0;
+  /** A part of the GUI that is kept between updates and only rebuilt when the data it shows changes.*/
+  template <class Key>
+  struct CachedGui {
+    Optional<Key> key;
+    PGuiElem elem;
+  };
+  typedef GameInfo::BandInfo BandInfo;
+  typedef GameInfo::PlayerInfo PlayerInfo;
+  typedef UniqueEntity<Creature>::Id CreatureId;
+  struct GuiCache {
+    CachedGui<tuple<vector<GameInfo::CreatureInfo>, vector<GameInfo::CreatureInfo>, string,
+        map<TeamId, vector<CreatureId>>, Optional<TeamId>, ViewObject, int, int, string>> minions;
+    CachedGui<tuple<vector<BandInfo::Button>, int>> buildings;
+    CachedGui<tuple<vector<BandInfo::Button>, vector<BandInfo::TechButton>, int>> technology;
+    CachedGui<vector<BandInfo::Deity>> deities;
+    CachedGui<vector<GameInfo::VillageInfo::Village>> villages;
+    CachedGui<int> keeperHelp;
+    CachedGui<tuple<string, vector<GameInfo::CreatureInfo>, map<CreatureId, string>, Optional<TeamId>,
+        map<TeamId, vector<CreatureId>>>> minionWindow;
+    CachedGui<tuple<string, vector<PlayerInfo::AttributeInfo>, vector<PlayerInfo::SkillInfo>,
+        vector<PlayerInfo::Effect>>> playerStats;
+    CachedGui<int> playerHelp;
+  };
+  /** Everything the render thread needs to draw the game. The game thread fills one in updateView and
+      the render thread switches to it at the start of refreshView.*/
+  struct FrameSnapshot {
+    GameInfo gameInfo;
+    Table<Optional<ViewIndex>> objects = Table<Optional<ViewIndex>>(0, 0);
+    Table<int> tileUpdates = Table<int>(0, 0);
+    vector<PGuiElem> guiElems;
+    GuiCache guiCache;
+    const MapMemory* memory = nullptr;
+    int frame = -1;
+    /** The map view the objects were built for, applied to the MapGui together with them.*/
+    MapLayout* layout = nullptr;
+    Vec2 layoutPos;
+    Optional<Vec2> center;
+    Rectangle levelBounds = Rectangle(1, 1);
+  };
+  TripleBuffer<FrameSnapshot> frames;
+  GameInfo::InfoType infoType = GameInfo::InfoType::PLAYER;
 
   MapLayout* mapLayout;
   MapGui* mapGui;
   MinimapGui* minimapGui;
   PGuiElem mapDecoration;
   PGuiElem minimapDecoration;
-  vector<PGuiElem> tempGuiElems;
   vector<GuiElem*> getAllGuiElems();
   vector<GuiElem*> getClickableGuiElems();
   SyncQueue<UserInput> inputQueue;